@@ -0,0 +1,645 @@
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+#include <fftw3.h>
+
+#include "Dsp/PowerSpectralDensity.hpp"
+#include "Dsp/AnomalyDetection.hpp"
+#include "Dsp/SpectralKernels.hpp"
+#include "Dsp/SpectralAnomalyDetection.hpp"
+#include "Dsp/BatchAnomalyDetection.hpp"
+#include "Dsp/FftPlanCache.hpp"
+#include "Io/SpectrumRing.hpp"
+#include "DataStructure/LatencyHistogram.hpp"
+
+// Times the Dsp hot paths across FFT sizes and anomaly window sizes, writes
+// the results as CSV and/or JSON and compares them against a baseline CSV
+// recorded earlier on the same machine.
+//
+// Usage: dsp_bench [--csv FILE] [--json FILE] [--baseline FILE]
+//                  [--write-baseline FILE] [--tolerance FRACTION]
+//                  [--min-size N] [--max-size N] [--filter SUBSTRING]
+//                  [--batch-ms MS]
+//
+// Exits non-zero when a benchmark is slower than its baseline by more than
+// the tolerance, or when the SIMD kernels disagree with the scalar ones.
+// execute() windows its input in place, so its timing includes restoring
+// the input from a pristine copy.
+
+namespace
+{
+    const size_t BATCH_COUNT = 5;
+
+    // Frames per psd.executeBatch op; compare with as many psd.execute ops.
+    const size_t FFT_BATCH_FRAMES = 8;
+
+    // Threads for psd.executeBatchThreaded, the same batch split across them.
+    const size_t FFT_THREADS = 4;
+
+    struct Options
+    {
+        std::string csvFile;
+        std::string jsonFile;
+        std::string baselineFile;
+        std::string writeBaselineFile;
+        std::string filter;
+        double tolerance = 0.15;
+        double batchMs = 20.0;
+        size_t minSize = 64;
+        size_t maxSize = 1 << 20;
+    };
+
+    struct Result
+    {
+        std::string name;
+        size_t size;
+        double nsPerOp;
+        size_t iterations;
+    };
+
+    struct AlignedDeleter
+    {
+        void operator()(void *p) const
+        {
+            fftwf_free(p);
+        }
+    };
+
+    template <typename T>
+    using AlignedBuffer = std::unique_ptr<T[], AlignedDeleter>;
+
+    template <typename T>
+    AlignedBuffer<T> allocate(size_t count)
+    {
+        return AlignedBuffer<T>(static_cast<T *>(fftwf_malloc(sizeof(T) * count)));
+    }
+
+    template <typename F>
+    double timeBatch(F &f, size_t iterations)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            f();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    // Grows the iteration count until one batch takes batchMs, then reports
+    // the median ns/op over BATCH_COUNT batches.
+    template <typename F>
+    Result measure(const Options &options, const std::string &name, size_t size, F f)
+    {
+        f();
+
+        size_t iterations = 1;
+        while (timeBatch(f, iterations) < options.batchMs * 1e6 && iterations < (size_t(1) << 30))
+        {
+            iterations *= 2;
+        }
+
+        std::vector<double> perOp;
+        for (size_t b = 0; b < BATCH_COUNT; b++)
+        {
+            perOp.push_back(timeBatch(f, iterations) / iterations);
+        }
+        std::sort(perOp.begin(), perOp.end());
+
+        Result result{name, size, perOp[BATCH_COUNT / 2], iterations};
+        std::printf("%-28s %10zu %16.1f %12zu\n", name.c_str(), size, result.nsPerOp, iterations);
+        std::fflush(stdout);
+        return result;
+    }
+
+    bool selected(const Options &options, const std::string &name)
+    {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+    std::vector<std::complex<float>> noise(size_t size, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::normal_distribution<float> normal(0.0f, 0.1f);
+        std::vector<std::complex<float>> samples(size);
+        for (auto &s : samples)
+        {
+            s = std::complex<float>(normal(rng), normal(rng));
+        }
+        return samples;
+    }
+
+    struct NativeInput
+    {
+        const char *name;
+        Dsp::SampleFormat format;
+        std::vector<uint8_t> bytes;
+    };
+
+    // The samples quantised the way a device would deliver them natively.
+    std::vector<NativeInput> quantise(const std::vector<std::complex<float>> &samples)
+    {
+        std::vector<NativeInput> inputs;
+        const struct
+        {
+            const char *name;
+            Dsp::SampleFormat::Type type;
+            float fullScale;
+        } formats[] = {{"psd.executeCS16", Dsp::SampleFormat::Type::CS16, 32768.0f},
+                       {"psd.executeCS8", Dsp::SampleFormat::Type::CS8, 128.0f},
+                       {"psd.executeCU8", Dsp::SampleFormat::Type::CU8, 127.5f}};
+        for (const auto &f : formats)
+        {
+            NativeInput input{f.name, Dsp::SampleFormat(), {}};
+            input.format.type = f.type;
+            input.format.scale = 1.0f / f.fullScale;
+            input.bytes.resize(samples.size() * input.format.bytesPerSample());
+            for (size_t i = 0; i < 2 * samples.size(); i++)
+            {
+                float v = i % 2 == 0 ? samples[i / 2].real() : samples[i / 2].imag();
+                long q = lroundf(v * f.fullScale);
+                if (f.type == Dsp::SampleFormat::Type::CS16)
+                {
+                    int16_t x = static_cast<int16_t>(std::clamp(q, -32768L, 32767L));
+                    std::memcpy(input.bytes.data() + 2 * i, &x, sizeof(x));
+                }
+                else if (f.type == Dsp::SampleFormat::Type::CS8)
+                {
+                    input.bytes[i] = static_cast<uint8_t>(static_cast<int8_t>(std::clamp(q, -128L, 127L)));
+                }
+                else
+                {
+                    input.bytes[i] = static_cast<uint8_t>(std::clamp(lroundf(v * f.fullScale + 127.5f), 0L, 255L));
+                }
+            }
+            inputs.push_back(std::move(input));
+        }
+        return inputs;
+    }
+
+    void runPsd(const Options &options, std::vector<Result> &results, int &status)
+    {
+        const char *cases[] = {"psd.execute", "psd.executeCS16", "psd.executeCS8", "psd.executeCU8", "psd.executeBatch", "psd.executeBatchThreaded", "psd.computeRealPsd", "psd.computeAvgPower", "psd.welch",
+                               "bins.process", "psd.toFile", "ring.write"};
+        if (std::none_of(std::begin(cases), std::end(cases), [&](const char *name)
+                         { return selected(options, name); }))
+        {
+            return;
+        }
+
+        for (size_t size = options.minSize; size <= options.maxSize; size *= 2)
+        {
+            // setFftSize maps bandwidth to 64 bins per MHz.
+            const double bandwidth = static_cast<double>(size) / 64.0 * 1e6;
+            const float sampleRate = static_cast<float>(bandwidth);
+
+            Dsp::PowerSpectralDensity psd;
+            psd.setFftSize(bandwidth);
+            if (psd.getFftSize() != size)
+            {
+                std::fprintf(stderr, "Unexpected FFT size %zu for %zu\n", psd.getFftSize(), size);
+                status = EXIT_FAILURE;
+                continue;
+            }
+
+            std::vector<std::complex<float>> pristine = noise(size, static_cast<unsigned>(size));
+            AlignedBuffer<std::complex<float>> in = allocate<std::complex<float>>(size);
+            AlignedBuffer<std::complex<float>> out = allocate<std::complex<float>>(size);
+            AlignedBuffer<float> real = allocate<float>(size);
+            std::copy(pristine.begin(), pristine.end(), in.get());
+            psd.execute(in.get(), out.get());
+
+            if (selected(options, "psd.execute"))
+            {
+                results.push_back(measure(options, "psd.execute", size, [&]
+                                          {
+                                              std::copy(pristine.begin(), pristine.end(), in.get());
+                                              psd.execute(in.get(), out.get());
+                                          }));
+            }
+
+            // From a native format execute() leaves its input untouched, so
+            // there is nothing to restore.
+            std::vector<NativeInput> natives = quantise(pristine);
+            for (const NativeInput &native : natives)
+            {
+                if (selected(options, native.name))
+                {
+                    results.push_back(measure(options, native.name, size, [&]
+                                              { psd.execute(native.bytes.data(), native.format, out.get()); }));
+                }
+            }
+
+            if (selected(options, "psd.executeBatch") || selected(options, "psd.executeBatchThreaded"))
+            {
+                std::vector<std::complex<float>> frames;
+                for (size_t f = 0; f < FFT_BATCH_FRAMES; f++)
+                {
+                    frames.insert(frames.end(), pristine.begin(), pristine.end());
+                }
+                AlignedBuffer<std::complex<float>> spectra = allocate<std::complex<float>>(FFT_BATCH_FRAMES * size);
+                if (selected(options, "psd.executeBatch"))
+                {
+                    results.push_back(measure(options, "psd.executeBatch", size, [&]
+                                              { psd.executeBatch(frames.data(), Dsp::SampleFormat(), FFT_BATCH_FRAMES, spectra.get()); }));
+                }
+                if (selected(options, "psd.executeBatchThreaded"))
+                {
+                    Dsp::PowerSpectralDensity threaded(psd);
+                    threaded.setThreadCount(FFT_THREADS);
+                    results.push_back(measure(options, "psd.executeBatchThreaded", size, [&]
+                                              { threaded.executeBatch(frames.data(), Dsp::SampleFormat(), FFT_BATCH_FRAMES, spectra.get()); }));
+                }
+            }
+            if (selected(options, "psd.computeRealPsd"))
+            {
+                results.push_back(measure(options, "psd.computeRealPsd", size, [&]
+                                          { psd.computeRealPsd(out.get(), real.get(), sampleRate); }));
+            }
+            if (selected(options, "psd.computeAvgPower"))
+            {
+                volatile double sink = 0;
+                results.push_back(measure(options, "psd.computeAvgPower", size, [&]
+                                          { sink = psd.computeAvgPower(out.get()); }));
+            }
+            if (selected(options, "psd.welch"))
+            {
+                psd.setWelch(8, 0.5f);
+                results.push_back(measure(options, "psd.welch", size, [&]
+                                          { psd.welch(pristine.data(), size, real.get(), sampleRate); }));
+            }
+            if (selected(options, "bins.process"))
+            {
+                Dsp::SpectralAnomalyDetection binDet;
+                psd.computeRealPsd(out.get(), real.get(), sampleRate);
+                results.push_back(measure(options, "bins.process", size, [&]
+                                          { binDet.process(real.get(), size); }));
+            }
+            if (selected(options, "psd.toFile"))
+            {
+                results.push_back(measure(options, "psd.toFile", size, [&]
+                                          { Dsp::PowerSpectralDensity::toFile("dsp_bench_psd.txt", 58e6, bandwidth, real.get(), size); }));
+                std::remove("dsp_bench_psd.txt");
+            }
+            if (selected(options, "ring.write"))
+            {
+                Io::SpectrumRing ring("dsp_bench_psd.bin", static_cast<uint32_t>(size), 8);
+                int64_t timestamp = 0;
+                results.push_back(measure(options, "ring.write", size, [&]
+                                          { ring.write(58e6, bandwidth, real.get(), size, timestamp++); }));
+                std::remove("dsp_bench_psd.bin");
+            }
+
+            // The fused conversion must match its scalar reference, over an
+            // odd length that leaves a scalar tail. The dB kernels are
+            // checked by kernel_check.
+            std::vector<float> window(size, 0.5f);
+            std::vector<std::complex<float>> converted(size - 1);
+            std::vector<std::complex<float>> convertedReference(size - 1);
+            for (const NativeInput &native : natives)
+            {
+                Dsp::SpectralKernels::convertWindow(native.bytes.data(), native.format, window.data(), converted.data(), size - 1);
+                Dsp::SpectralKernels::convertWindowScalar(native.bytes.data(), native.format, window.data(), convertedReference.data(), size - 1);
+                if (std::equal(converted.begin(), converted.end(), convertedReference.begin()) == false)
+                {
+                    std::fprintf(stderr, "convertWindow (%s, %s) differs from scalar at size %zu\n",
+                                 Dsp::SpectralKernels::isa(), native.format.name(), size);
+                    status = EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    void runAnomaly(const Options &options, std::vector<Result> &results)
+    {
+        for (size_t window : {Dsp::AnomalyDetection::CALIBRATION_SIZE, size_t(4096), Dsp::AnomalyDetection::MAX_SIZE})
+        {
+            std::mt19937 rng(static_cast<unsigned>(window));
+            std::cauchy_distribution<double> cauchy(1.0, 0.25);
+            std::vector<double> samples(window);
+            for (auto &s : samples)
+            {
+                s = cauchy(rng);
+            }
+
+            Dsp::AnomalyDetection anomDet;
+            for (double s : samples)
+            {
+                anomDet.pushSample(s);
+            }
+            anomDet.processDistribution();
+
+            if (selected(options, "anom.processDistribution"))
+            {
+                results.push_back(measure(options, "anom.processDistribution", window, [&]
+                                          { anomDet.processDistribution(); }));
+            }
+            if (selected(options, "anom.mle"))
+            {
+                volatile double sink = 0;
+                const double x0 = anomDet.getX0();
+                const double sigma = anomDet.getSigma();
+                results.push_back(measure(options, "anom.mle", window, [&]
+                                          { sink = Dsp::AnomalyDetection::mle(samples, x0, sigma); }));
+            }
+            if (selected(options, "anom.pushSampleRefit"))
+            {
+                size_t i = 0;
+                results.push_back(measure(options, "anom.pushSampleRefit", window, [&]
+                                          {
+                                              anomDet.pushSample(samples[i]);
+                                              anomDet.refitLocationScale();
+                                              i = i + 1 == window ? 0 : i + 1;
+                                          }));
+            }
+            if (selected(options, "anom.isAnomaly"))
+            {
+                volatile bool sink = false;
+                size_t i = 0;
+                results.push_back(measure(options, "anom.isAnomaly", window, [&]
+                                          {
+                                              sink = anomDet.isAnomaly(samples[i]);
+                                              i = i + 1 == window ? 0 : i + 1;
+                                          }));
+            }
+            if (selected(options, "anom.toFile"))
+            {
+                results.push_back(measure(options, "anom.toFile", window, [&]
+                                          { anomDet.toFile("dsp_bench_cauchy.txt"); }));
+                std::remove("dsp_bench_cauchy.txt");
+            }
+        }
+    }
+
+    // One power sample per channel against each channel's own model: a
+    // loop of AnomalyDetection::isAnomaly() calls versus one batched pass.
+    void runChannelDetection(const Options &options, std::vector<Result> &results, int &status)
+    {
+        const char *cases[] = {"anom.isAnomalyChannels", "anom.batchIsAnomaly"};
+        if (std::none_of(std::begin(cases), std::end(cases), [&](const char *name)
+                         { return selected(options, name); }))
+        {
+            return;
+        }
+
+        for (size_t channels : {size_t(16), size_t(256), size_t(4096)})
+        {
+            std::mt19937 rng(static_cast<unsigned>(channels));
+            std::uniform_real_distribution<double> location(1e-6, 1e-3);
+            std::uniform_real_distribution<double> skew(-0.5, 0.5);
+            std::cauchy_distribution<float> residual(0.0f, 1.0f);
+
+            std::vector<Dsp::AnomalyDetection> detectors(channels);
+            Dsp::BatchAnomalyDetection batch;
+            batch.reset(channels);
+            std::vector<float> x0(channels);
+            std::vector<float> sigma(channels);
+            std::vector<float> lambda(channels);
+            std::vector<float> samples(channels);
+            for (size_t k = 0; k < channels; k++)
+            {
+                Model::CauchyParams params{location(rng), 0.0, skew(rng)};
+                params.sigma = params.x0 * 0.1;
+                detectors[k].warmStart(params);
+                batch.setModel(k, detectors[k]);
+                x0[k] = static_cast<float>(params.x0);
+                sigma[k] = static_cast<float>(params.sigma);
+                lambda[k] = static_cast<float>(params.lambda);
+                samples[k] = static_cast<float>(params.x0 + params.sigma * residual(rng));
+            }
+
+            if (selected(options, "anom.isAnomalyChannels"))
+            {
+                volatile bool sink = false;
+                results.push_back(measure(options, "anom.isAnomalyChannels", channels, [&]
+                                          {
+                                              for (size_t k = 0; k < channels; k++)
+                                              {
+                                                  sink = detectors[k].isAnomaly(samples[k]);
+                                              }
+                                          }));
+            }
+            if (selected(options, "anom.batchIsAnomaly"))
+            {
+                volatile size_t sink = 0;
+                results.push_back(measure(options, "anom.batchIsAnomaly", channels, [&]
+                                          { sink = batch.process(samples.data(), channels); }));
+            }
+
+            // The dispatched tail kernel must stay within TOLERANCE_TAIL of
+            // the atan reference, over an odd length that leaves a tail.
+            std::vector<float> fast(channels - 1);
+            std::vector<float> reference(channels - 1);
+            Dsp::SpectralKernels::cauchyTail(samples.data(), x0.data(), sigma.data(), lambda.data(), fast.data(), channels - 1);
+            Dsp::SpectralKernels::cauchyTailScalar(samples.data(), x0.data(), sigma.data(), lambda.data(), reference.data(), channels - 1);
+            float maxError = 0.0f;
+            for (size_t k = 0; k < channels - 1; k++)
+            {
+                maxError = std::max(maxError, fabsf(fast[k] - reference[k]));
+            }
+            if (maxError > Dsp::SpectralKernels::TOLERANCE_TAIL)
+            {
+                std::fprintf(stderr, "cauchyTail (%s) differs from scalar by %g at %zu channels\n",
+                             Dsp::SpectralKernels::isa(), maxError, channels);
+                status = EXIT_FAILURE;
+            }
+        }
+    }
+
+    // Cost of one timed stage: two clock reads plus a histogram record, as
+    // done by Sdr::PipelineMetrics::ScopedTimer on its sampled calls.
+    void runInstrumentation(const Options &options, std::vector<Result> &results)
+    {
+        if (selected(options, "metrics.stageTimer") == false)
+        {
+            return;
+        }
+
+        static Ds::LatencyHistogram histogram;
+        results.push_back(measure(options, "metrics.stageTimer", 1, [&]
+                                  {
+                                      auto start = std::chrono::steady_clock::now();
+                                      auto elapsed = std::chrono::steady_clock::now() - start;
+                                      histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+                                  }));
+    }
+
+    void writeCsv(const std::string &fileName, const std::vector<Result> &results)
+    {
+        std::ofstream os(fileName, std::ios::trunc);
+        os << std::fixed << std::setprecision(1);
+        os << "benchmark,size,ns_per_op,iterations\n";
+        for (const auto &r : results)
+        {
+            os << r.name << ',' << r.size << ',' << r.nsPerOp << ',' << r.iterations << '\n';
+        }
+    }
+
+    void writeJson(const std::string &fileName, const std::vector<Result> &results)
+    {
+        std::ofstream os(fileName, std::ios::trunc);
+        os << std::fixed << std::setprecision(1);
+        os << "{\n  \"isa\": \"" << Dsp::SpectralKernels::isa() << "\",\n  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const auto &r = results[i];
+            os << "    {\"benchmark\": \"" << r.name << "\", \"size\": " << r.size
+               << ", \"ns_per_op\": " << r.nsPerOp << ", \"iterations\": " << r.iterations << '}'
+               << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        os << "  ]\n}\n";
+    }
+
+    std::vector<Result> readCsv(const std::string &fileName)
+    {
+        std::ifstream is(fileName);
+        if (is.is_open() == false)
+        {
+            throw std::runtime_error("Failed to open baseline " + fileName);
+        }
+
+        std::vector<Result> results;
+        std::string line;
+        std::getline(is, line);
+        while (std::getline(is, line))
+        {
+            std::stringstream ss(line);
+            std::string name;
+            std::string size;
+            std::string nsPerOp;
+            std::string iterations;
+            if (std::getline(ss, name, ',') && std::getline(ss, size, ',') &&
+                std::getline(ss, nsPerOp, ',') && std::getline(ss, iterations, ','))
+            {
+                results.push_back(Result{name, std::stoul(size), std::stod(nsPerOp), std::stoul(iterations)});
+            }
+        }
+        return results;
+    }
+
+    // Returns the number of regressions beyond the tolerance.
+    size_t compare(const std::vector<Result> &baseline, const std::vector<Result> &results, double tolerance)
+    {
+        size_t regressions = 0;
+        std::printf("\n%-28s %10s %16s %16s %8s\n", "benchmark", "size", "baseline_ns", "current_ns", "ratio");
+        for (const auto &r : results)
+        {
+            auto it = std::find_if(baseline.begin(), baseline.end(), [&](const Result &b)
+                                   { return b.name == r.name && b.size == r.size; });
+            if (it == baseline.end())
+            {
+                continue;
+            }
+
+            double ratio = r.nsPerOp / it->nsPerOp;
+            bool regressed = ratio > 1.0 + tolerance;
+            regressions += regressed ? 1 : 0;
+            std::printf("%-28s %10zu %16.1f %16.1f %8.2f%s\n",
+                        r.name.c_str(), r.size, it->nsPerOp, r.nsPerOp, ratio, regressed ? "  REGRESSION" : "");
+        }
+        return regressions;
+    }
+
+    bool parse(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            if (i + 1 >= argc)
+            {
+                return false;
+            }
+
+            std::string value = argv[++i];
+            if (arg == "--csv")
+                options.csvFile = value;
+            else if (arg == "--json")
+                options.jsonFile = value;
+            else if (arg == "--baseline")
+                options.baselineFile = value;
+            else if (arg == "--write-baseline")
+                options.writeBaselineFile = value;
+            else if (arg == "--filter")
+                options.filter = value;
+            else if (arg == "--tolerance")
+                options.tolerance = std::stod(value);
+            else if (arg == "--batch-ms")
+                options.batchMs = std::stod(value);
+            else if (arg == "--min-size")
+                options.minSize = std::stoul(value);
+            else if (arg == "--max-size")
+                options.maxSize = std::stoul(value);
+            else
+                return false;
+        }
+        return options.minSize >= 64 && (options.minSize & (options.minSize - 1)) == 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (parse(argc, argv, options) == false)
+    {
+        std::fprintf(stderr, "Usage: %s [--csv FILE] [--json FILE] [--baseline FILE] [--write-baseline FILE] "
+                             "[--tolerance FRACTION] [--min-size N] [--max-size N] [--filter SUBSTRING] [--batch-ms MS]\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::printf("kernels: %s\n", Dsp::SpectralKernels::isa());
+    std::printf("%-28s %10s %16s %12s\n", "benchmark", "size", "ns_per_op", "iterations");
+
+    int status = EXIT_SUCCESS;
+    std::vector<Result> results;
+    try
+    {
+        // Initialises FFTW threads before the first fftwf_malloc().
+        Dsp::FftPlanCache::instance();
+
+        runPsd(options, results, status);
+        runAnomaly(options, results);
+        runChannelDetection(options, results, status);
+        runInstrumentation(options, results);
+
+        if (options.csvFile.empty() == false)
+        {
+            writeCsv(options.csvFile, results);
+        }
+        if (options.jsonFile.empty() == false)
+        {
+            writeJson(options.jsonFile, results);
+        }
+        if (options.writeBaselineFile.empty() == false)
+        {
+            writeCsv(options.writeBaselineFile, results);
+        }
+        if (options.baselineFile.empty() == false)
+        {
+            size_t regressions = compare(readCsv(options.baselineFile), results, options.tolerance);
+            if (regressions > 0)
+            {
+                std::printf("%zu benchmark(s) regressed by more than %.0f%%\n", regressions, options.tolerance * 100.0);
+                status = EXIT_FAILURE;
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "dsp_bench failed: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return status;
+}
@@ -0,0 +1,70 @@
+#include <math.h>
+#include <random>
+#include <vector>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "Dsp/SpectralKernels.hpp"
+
+// Checks the dispatched PSD kernels against their scalar references: every
+// FFT size the PSD uses must stay within SpectralKernels::TOLERANCE_DB.
+// Registered with ctest; exits non-zero on a violation.
+
+static float maxError(const std::vector<float> &fast, const std::vector<float> &reference)
+{
+    float error = 0.0f;
+    for (size_t i = 0; i < fast.size(); i++)
+    {
+        error = std::max(error, fabsf(fast[i] - reference[i]));
+    }
+    return error;
+}
+
+int main()
+{
+    std::printf("kernels: %s\n", Dsp::SpectralKernels::isa());
+    std::printf("%-8s %8s %14s\n", "kernel", "size", "max_error_db");
+
+    // Bins spread over 180 dB of dynamic range, never exactly zero.
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> exponent(-9.0f, 0.0f);
+    std::uniform_real_distribution<float> phase(0.0f, 2.0f * static_cast<float>(M_PI));
+
+    int status = EXIT_SUCCESS;
+    for (size_t size = 64; size <= 65536; size *= 2)
+    {
+        std::vector<std::complex<float>> fft(size);
+        std::vector<float> power(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            fft[i] = std::polar(powf(10.0f, exponent(rng)), phase(rng));
+            power[i] = std::norm(fft[i]);
+        }
+
+        const float scale = 1.0f / (static_cast<float>(size) * 2.4e6f);
+        std::vector<float> fast(size);
+        std::vector<float> reference(size);
+
+        Dsp::SpectralKernels::powerDb(fft.data(), fast.data(), size, scale);
+        Dsp::SpectralKernels::powerDbScalar(fft.data(), reference.data(), size, scale);
+        float powerDbError = maxError(fast, reference);
+        std::printf("%-8s %8zu %14g\n", "powerDb", size, powerDbError);
+
+        Dsp::SpectralKernels::toDb(power.data(), fast.data(), size, scale);
+        Dsp::SpectralKernels::toDbScalar(power.data(), reference.data(), size, scale);
+        float toDbError = maxError(fast, reference);
+        std::printf("%-8s %8zu %14g\n", "toDb", size, toDbError);
+
+        // NaN fails too, so the comparison is written to reject it.
+        if ((powerDbError <= Dsp::SpectralKernels::TOLERANCE_DB) == false ||
+            (toDbError <= Dsp::SpectralKernels::TOLERANCE_DB) == false)
+        {
+            std::fprintf(stderr, "%s kernels exceed %g dB at size %zu\n",
+                         Dsp::SpectralKernels::isa(), Dsp::SpectralKernels::TOLERANCE_DB, size);
+            status = EXIT_FAILURE;
+        }
+    }
+    return status;
+}
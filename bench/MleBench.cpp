@@ -0,0 +1,79 @@
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Dsp/AnomalyDetection.hpp"
+
+// Compares AnomalyDetection::mle (Brent, cold and warm-started) against the
+// exhaustive mleGrid search on asymmetric Cauchy samples.
+
+static std::vector<double> asymmetricCauchy(size_t count, double x_0, double sigma, double lambda, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(1e-9, 1.0 - 1e-9);
+    const double split = (1.0 - lambda) / 2.0;
+
+    std::vector<double> samples(count);
+    for (auto &sample : samples)
+    {
+        double u = uniform(rng);
+        double side = u < split ? 1.0 - lambda : 1.0 + lambda;
+        sample = x_0 + sigma * side * tan(M_PI * (u - split) / side);
+    }
+    return samples;
+}
+
+template <typename F>
+static double timeMs(F f, size_t repetitions)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions; i++)
+    {
+        f();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / repetitions;
+}
+
+int main()
+{
+    const double x_0 = 1.0;
+    const double sigma = 0.25;
+
+    std::printf("%8s %8s %12s %12s %12s %10s %10s %10s\n",
+                "samples", "lambda", "grid_ms", "brent_ms", "warm_ms", "grid_l", "brent_l", "diff");
+
+    int status = EXIT_SUCCESS;
+    for (size_t count : {256, 4096, 16384})
+    {
+        for (double lambda : {-0.5, 0.0, 0.3, 0.8})
+        {
+            std::vector<double> samples = asymmetricCauchy(count, x_0, sigma, lambda, static_cast<unsigned>(count));
+
+            double gridLambda = 0.0;
+            double brentLambda = 0.0;
+            double warmLambda = 0.0;
+            double gridMs = timeMs([&]
+                                   { gridLambda = Dsp::AnomalyDetection::mleGrid(samples, x_0, sigma); }, 1);
+            double brentMs = timeMs([&]
+                                    { brentLambda = Dsp::AnomalyDetection::mle(samples, x_0, sigma); }, 20);
+            double warmMs = timeMs([&]
+                                   { warmLambda = Dsp::AnomalyDetection::mle(samples, x_0, sigma, gridLambda + 0.01); }, 20);
+
+            double diff = std::max(fabs(gridLambda - brentLambda), fabs(gridLambda - warmLambda));
+            std::printf("%8zu %8.2f %12.3f %12.3f %12.3f %10.4f %10.4f %10.6f\n",
+                        count, lambda, gridMs, brentMs, warmMs, gridLambda, brentLambda, diff);
+
+            // The grid only resolves lambda to D_THETA.
+            if (diff > 0.0002)
+            {
+                status = EXIT_FAILURE;
+            }
+        }
+    }
+
+    return status;
+}
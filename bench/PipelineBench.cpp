@@ -0,0 +1,70 @@
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Sdr/RtlSdrV4.hpp"
+#include "Sdr/LimeSdrMini2.hpp"
+#include "Sdr/Orchestrator.hpp"
+#include "Sdr/ReplayDevice.hpp"
+
+// Runs the Lime and RTL processing loops end to end on synthetic replay
+// devices, unpaced, and reports how many times real time each one keeps up.
+// The warm-up covers the initial calibration, whose samples are spaced
+// 20 ms apart in time (per channel on the RTL, which interleaves them with
+// its sweep), so it takes seconds regardless of speed.
+//
+// Usage: pipeline_bench [seconds] [speed] [warmup_seconds]   (speed 0 = unpaced)
+
+int main(int argc, char **argv)
+{
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+    const double speed = argc > 2 ? std::atof(argv[2]) : 0.0;
+    const double warmup = argc > 3 ? std::atof(argv[3]) : 20.0;
+
+    const double limeFrequency = 58e6;
+    const double limeBandwidth = 8e6;
+
+    Sdr::ReplayDevice::Config limeConfig;
+    limeConfig.source = Sdr::ReplayDevice::Source::Burst;
+    limeConfig.toneFrequency = limeFrequency + 1e6;
+    limeConfig.speed = speed;
+
+    Sdr::ReplayDevice::Config rtlConfig;
+    rtlConfig.source = Sdr::ReplayDevice::Source::Tone;
+    rtlConfig.toneFrequency = 470.1e6;
+    rtlConfig.speed = speed;
+    rtlConfig.seed = 2;
+
+    Sdr::Orchestrator orchestrator;
+
+    auto &lime = orchestrator.add(std::make_unique<Sdr::LimeSdrMini2>(std::make_unique<Sdr::ReplayDevice>(limeConfig)));
+    lime.configure(limeFrequency, limeBandwidth);
+    lime.setOutputPrefix("lime_");
+
+    auto rtl = std::make_unique<Sdr::RtlSdrV4>(std::make_unique<Sdr::ReplayDevice>(rtlConfig));
+    rtl->setFrequencies({460e6, 470e6, 480e6});
+    rtl->setOutputPrefix("rtlsdr_");
+    orchestrator.add(std::move(rtl));
+
+    orchestrator.start();
+    std::this_thread::sleep_for(std::chrono::duration<double>(warmup));
+    orchestrator.report();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    auto reports = orchestrator.report();
+    orchestrator.stop();
+
+    const double sampleRates[] = {limeBandwidth, Sdr::RtlSdrV4::BANDWIDTH_HZ};
+    std::printf("%-8s %12s %12s %12s\n", "device", "MS/s", "frames/s", "x_realtime");
+    for (size_t i = 0; i < reports.size(); i++)
+    {
+        std::printf("%-8s %12.3f %12.1f %12.2f\n",
+                    reports[i].driver.c_str(),
+                    reports[i].samplesPerSecond / 1e6,
+                    reports[i].framesPerSecond,
+                    reports[i].samplesPerSecond / sampleRates[i]);
+    }
+
+    return EXIT_SUCCESS;
+}
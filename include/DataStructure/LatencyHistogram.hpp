@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Ds
+{
+    // Log-linear (HDR-style) histogram of non-negative integer values such
+    // as nanosecond latencies. Every power-of-two range is split into
+    // 2^SUB_BUCKET_BITS linear buckets, bounding the relative error of a
+    // reported quantile to 2^-SUB_BUCKET_BITS. record() is wait-free: a few
+    // relaxed atomic adds and no allocation, so any thread may record while
+    // another reads a snapshot.
+    class LatencyHistogram
+    {
+    public:
+        inline static const size_t SUB_BUCKET_BITS = 5;
+        inline static const size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+        inline static const size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+        struct Snapshot
+        {
+            std::array<uint64_t, BUCKET_COUNT> counts{};
+            uint64_t count = 0;
+            uint64_t sum = 0;
+            uint64_t max = 0;
+
+            double mean() const
+            {
+                return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+            }
+
+            // Upper bound of the bucket holding the q-th quantile, 0 <= q <= 1.
+            uint64_t quantile(double q) const
+            {
+                if (count == 0)
+                {
+                    return 0;
+                }
+
+                uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+                uint64_t seen = 0;
+                for (size_t i = 0; i < BUCKET_COUNT; i++)
+                {
+                    seen += counts[i];
+                    if (seen >= rank)
+                    {
+                        uint64_t upper = upperBound(i);
+                        return upper < max ? upper : max;
+                    }
+                }
+                return max;
+            }
+        };
+
+        void record(uint64_t value)
+        {
+            m_counts[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+            m_count.fetch_add(1, std::memory_order_relaxed);
+            m_sum.fetch_add(value, std::memory_order_relaxed);
+
+            uint64_t max = m_max.load(std::memory_order_relaxed);
+            while (value > max && m_max.compare_exchange_weak(max, value, std::memory_order_relaxed) == false)
+            {
+            }
+        }
+
+        // Not an atomic cut across buckets; counts recorded concurrently may
+        // land in either this snapshot or the next.
+        Snapshot snapshot() const
+        {
+            Snapshot s;
+            for (size_t i = 0; i < BUCKET_COUNT; i++)
+            {
+                s.counts[i] = m_counts[i].load(std::memory_order_relaxed);
+            }
+            s.count = m_count.load(std::memory_order_relaxed);
+            s.sum = m_sum.load(std::memory_order_relaxed);
+            s.max = m_max.load(std::memory_order_relaxed);
+            return s;
+        }
+
+        static size_t bucketOf(uint64_t value)
+        {
+            if (value < SUB_BUCKET_COUNT)
+            {
+                return static_cast<size_t>(value);
+            }
+
+            size_t msb = 63 - static_cast<size_t>(__builtin_clzll(value));
+            size_t shift = msb - SUB_BUCKET_BITS;
+            return ((shift + 1) << SUB_BUCKET_BITS) | static_cast<size_t>((value >> shift) & (SUB_BUCKET_COUNT - 1));
+        }
+
+        // Largest value that maps to `bucket`.
+        static uint64_t upperBound(size_t bucket)
+        {
+            if (bucket < SUB_BUCKET_COUNT)
+            {
+                return bucket;
+            }
+
+            size_t shift = (bucket >> SUB_BUCKET_BITS) - 1;
+            uint64_t base = (uint64_t(SUB_BUCKET_COUNT) | (bucket & (SUB_BUCKET_COUNT - 1))) << shift;
+            return base + ((uint64_t(1) << shift) - 1);
+        }
+
+    private:
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_counts{};
+        std::atomic<uint64_t> m_count{0};
+        std::atomic<uint64_t> m_sum{0};
+        std::atomic<uint64_t> m_max{0};
+    };
+}
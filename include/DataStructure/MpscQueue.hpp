@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace Ds
+{
+    // Lock-free multi-producer/single-consumer queue for control commands.
+    // Producers push onto a Treiber stack with one CAS; the consumer takes
+    // the whole stack with a single exchange and replays it oldest first,
+    // so there is no per-node pop and no ABA hazard. One allocation per
+    // push: meant for control traffic, not sample data.
+    template <typename T>
+    class MpscQueue
+    {
+    public:
+        MpscQueue() = default;
+
+        ~MpscQueue()
+        {
+            drain([](T &) {});
+        }
+
+        MpscQueue(const MpscQueue &) = delete;
+        MpscQueue &operator=(const MpscQueue &) = delete;
+
+        // Any thread.
+        void push(T value)
+        {
+            Node *node = new Node{std::move(value), m_head.load(std::memory_order_relaxed)};
+            while (m_head.compare_exchange_weak(node->next, node,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed) == false)
+            {
+            }
+        }
+
+        // Consumer only. Calls f on everything pushed so far, in push order,
+        // and returns how many there were.
+        template <typename F>
+        size_t drain(F &&f)
+        {
+            Node *node = m_head.exchange(nullptr, std::memory_order_acquire);
+
+            Node *reversed = nullptr;
+            while (node != nullptr)
+            {
+                Node *next = node->next;
+                node->next = reversed;
+                reversed = node;
+                node = next;
+            }
+
+            size_t count = 0;
+            while (reversed != nullptr)
+            {
+                Node *next = reversed->next;
+                f(reversed->value);
+                delete reversed;
+                reversed = next;
+                count++;
+            }
+            return count;
+        }
+
+        bool empty() const
+        {
+            return m_head.load(std::memory_order_acquire) == nullptr;
+        }
+
+    private:
+        struct Node
+        {
+            T value;
+            Node *next;
+        };
+
+        std::atomic<Node *> m_head{nullptr};
+    };
+}
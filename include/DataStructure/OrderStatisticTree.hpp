@@ -0,0 +1,191 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace Ds
+{
+    // Multiset with rank queries: insert, erase and kth are O(log n)
+    // expected. Implemented as a treap whose nodes live in one vector and
+    // are recycled through a free list, so a sliding window of fixed size
+    // does not allocate once it is full.
+    template <typename T>
+    class OrderStatisticTree
+    {
+    public:
+        void insert(const T &value)
+        {
+            int32_t node = allocate(value);
+            int32_t left;
+            int32_t right;
+            split(m_root, value, false, left, right);
+            m_root = merge(merge(left, node), right);
+        }
+
+        bool erase(const T &value)
+        {
+            int32_t left;
+            int32_t middle;
+            int32_t right;
+            split(m_root, value, false, left, middle);
+            split(middle, value, true, middle, right);
+
+            bool found = middle != NIL;
+            if (found)
+            {
+                int32_t removed = middle;
+                middle = merge(m_nodes[removed].left, m_nodes[removed].right);
+                m_free.push_back(removed);
+            }
+
+            m_root = merge(merge(left, middle), right);
+            return found;
+        }
+
+        // 0-based rank: kth(0) is the minimum, kth(size() - 1) the maximum.
+        const T &kth(size_t k) const
+        {
+            if (k >= size())
+            {
+                throw std::out_of_range("OrderStatisticTree rank out of range");
+            }
+
+            int32_t node = m_root;
+            while (true)
+            {
+                size_t leftSize = sizeOf(m_nodes[node].left);
+                if (k < leftSize)
+                {
+                    node = m_nodes[node].left;
+                }
+                else if (k == leftSize)
+                {
+                    return m_nodes[node].value;
+                }
+                else
+                {
+                    k -= leftSize + 1;
+                    node = m_nodes[node].right;
+                }
+            }
+        }
+
+        size_t size() const
+        {
+            return sizeOf(m_root);
+        }
+
+        bool empty() const
+        {
+            return m_root == NIL;
+        }
+
+        void reserve(size_t capacity)
+        {
+            m_nodes.reserve(capacity);
+            m_free.reserve(capacity);
+        }
+
+        void clear()
+        {
+            m_nodes.clear();
+            m_free.clear();
+            m_root = NIL;
+        }
+
+    private:
+        inline static const int32_t NIL = -1;
+
+        struct Node
+        {
+            T value;
+            uint32_t priority;
+            uint32_t size;
+            int32_t left;
+            int32_t right;
+        };
+
+        int32_t allocate(const T &value)
+        {
+            // xorshift32 priorities keep the treap balanced in expectation.
+            m_seed ^= m_seed << 13;
+            m_seed ^= m_seed >> 17;
+            m_seed ^= m_seed << 5;
+
+            Node node{value, m_seed, 1, NIL, NIL};
+            if (m_free.empty() == false)
+            {
+                int32_t index = m_free.back();
+                m_free.pop_back();
+                m_nodes[index] = node;
+                return index;
+            }
+            m_nodes.push_back(node);
+            return static_cast<int32_t>(m_nodes.size() - 1);
+        }
+
+        size_t sizeOf(int32_t node) const
+        {
+            return node == NIL ? 0 : m_nodes[node].size;
+        }
+
+        void update(int32_t node)
+        {
+            m_nodes[node].size = static_cast<uint32_t>(1 + sizeOf(m_nodes[node].left) + sizeOf(m_nodes[node].right));
+        }
+
+        // Splits `node` into values < `value` (or <= when inclusive) and the rest.
+        void split(int32_t node, const T &value, bool inclusive, int32_t &left, int32_t &right)
+        {
+            if (node == NIL)
+            {
+                left = NIL;
+                right = NIL;
+                return;
+            }
+
+            bool goesLeft = inclusive ? !(value < m_nodes[node].value) : m_nodes[node].value < value;
+            if (goesLeft)
+            {
+                split(m_nodes[node].right, value, inclusive, m_nodes[node].right, right);
+                left = node;
+            }
+            else
+            {
+                split(m_nodes[node].left, value, inclusive, left, m_nodes[node].left);
+                right = node;
+            }
+            update(node);
+        }
+
+        int32_t merge(int32_t left, int32_t right)
+        {
+            if (left == NIL)
+            {
+                return right;
+            }
+            if (right == NIL)
+            {
+                return left;
+            }
+
+            if (m_nodes[left].priority > m_nodes[right].priority)
+            {
+                m_nodes[left].right = merge(m_nodes[left].right, right);
+                update(left);
+                return left;
+            }
+
+            m_nodes[right].left = merge(left, m_nodes[right].left);
+            update(right);
+            return right;
+        }
+
+        std::vector<Node> m_nodes;
+        std::vector<int32_t> m_free;
+        int32_t m_root = NIL;
+        uint32_t m_seed = 2463534242u;
+    };
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Ds
+{
+    // Lock-free single-producer/single-consumer ring of pre-allocated slots.
+    // Slots are handed out in place: the producer fills the slot returned by
+    // tryAcquireWrite() and publishes it with commitWrite(), the consumer
+    // reads the slot returned by tryAcquireRead() and frees it with
+    // commitRead(). Nothing is allocated after construction.
+    template <typename T>
+    class SpscRingBuffer
+    {
+    public:
+        inline static const size_t CACHE_LINE_SIZE = 64;
+
+        explicit SpscRingBuffer(size_t capacity) : m_slots(roundUpPowerOfTwo(capacity)),
+                                                   m_mask(m_slots.size() - 1) {}
+
+        SpscRingBuffer(const SpscRingBuffer &) = delete;
+        SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+        // Producer side. Returns nullptr and counts an overrun when full.
+        T *tryAcquireWrite()
+        {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            if (head - m_producerTail >= m_slots.size())
+            {
+                m_producerTail = m_tail.load(std::memory_order_acquire);
+                if (head - m_producerTail >= m_slots.size())
+                {
+                    m_overruns.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+            }
+            return &m_slots[head & m_mask];
+        }
+
+        void commitWrite()
+        {
+            m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // Consumer side. Returns nullptr when empty; an underrun is counted
+        // once each time the consumer drains the ring and has to wait.
+        T *tryAcquireRead()
+        {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail == m_consumerHead)
+            {
+                m_consumerHead = m_head.load(std::memory_order_acquire);
+                if (tail == m_consumerHead)
+                {
+                    if (m_consumerStarved == false)
+                    {
+                        m_consumerStarved = true;
+                        m_underruns.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    return nullptr;
+                }
+            }
+            m_consumerStarved = false;
+            return &m_slots[tail & m_mask];
+        }
+
+        void commitRead()
+        {
+            m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // Direct slot access for pre-allocating slot payloads before the
+        // producer and consumer threads are started.
+        T &slot(size_t index)
+        {
+            return m_slots[index];
+        }
+
+        size_t capacity() const
+        {
+            return m_slots.size();
+        }
+
+        size_t size() const
+        {
+            return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+        }
+
+        uint64_t overrunCount() const
+        {
+            return m_overruns.load(std::memory_order_relaxed);
+        }
+
+        uint64_t underrunCount() const
+        {
+            return m_underruns.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static size_t roundUpPowerOfTwo(size_t value)
+        {
+            size_t result = 1;
+            while (result < value)
+            {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        std::vector<T> m_slots;
+        const size_t m_mask;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head{0};
+        size_t m_producerTail = 0;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail{0};
+        size_t m_consumerHead = 0;
+        bool m_consumerStarved = false;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_overruns{0};
+        std::atomic<uint64_t> m_underruns{0};
+    };
+}
@@ -1,36 +1,80 @@
 #pragma once
 
 #include <deque>
+#include <vector>
+
+#include "Dsp/DistributionFitter.hpp"
+#include "DataStructure/OrderStatisticTree.hpp"
 
 namespace Dsp
 {
     class AnomalyDetection
     {
     public:
-        inline static const size_t MAX_SIZE = 256;
+        inline static const size_t MAX_SIZE = 16384;
+        inline static const size_t CALIBRATION_SIZE = 256;
         inline static const size_t CONSECUTIVE_COUNT = 10;
 
         bool isReady() const;
+
+        // Adopts a previously calibrated model and starts detecting at once.
+        // The window refills from live samples, and location, scale and
+        // lambda are only refitted from it once it holds CALIBRATION_SIZE
+        // samples, so the stored model is refined rather than replaced by
+        // a fit to a handful of samples.
+        void warmStart(const Model::CauchyParams &params);
+        size_t getSampleCount() const;
         void processDistribution();
         void pushSample(double sample);
+
+        // Snapshots the window and fits it on the DistributionFitter
+        // worker; the result is adopted by the next updateModel().
+        void requestRefit();
+
+        // Adopts the latest background fit, if one has finished. Lock-free;
+        // call once per frame before isAnomaly(). Returns true on change.
+        bool updateModel();
+
+        // Re-derives x0 and sigma from the current window in O(log n),
+        // keeping lambda from the last processDistribution().
+        void refitLocationScale();
+
         bool isAnomaly(double sample, double alpha = 0.05);
 
+        double getX0() const;
+        double getSigma() const;
+        double getLambda() const;
+
+        void toFile(const char *fileName) const;
+
+        // Maximum-likelihood lambda for fixed x_0 and sigma. mle() runs a
+        // bounded Brent search warm-started around initialLambda; mleGrid()
+        // is the exhaustive D_THETA grid it replaces, kept as a reference.
+        static double mle(const std::vector<double> &samples, double x_0, double sigma, double initialLambda = 0.0);
+        static double mleGrid(const std::vector<double> &samples, double x_0, double sigma);
+
     private:
         inline static const double D_THETA = 0.0001;
+        inline static const double MLE_TOLERANCE = 0.00001;
+        inline static const double MLE_WARM_START_SPAN = 0.2;
+        inline static const size_t MLE_MAX_ITERATIONS = 100;
+
+        bool isWarming() const;
 
         static int sgn(double x);
         static double cdf(double x, double x_0, double sigma, double lambda);
         static double pdf(double x, double x_0, double sigma, double lambda);
-        static double mle(const std::vector<double> &samples, double x_0, double sigma);
         static double nll(const std::vector<double> &samples, double x_0, double sigma, double lambda);
 
-        void toFile(const char *fileName);
-
         std::deque<double> m_samples;
+        Ds::OrderStatisticTree<double> m_order;
+        std::vector<double> m_distribution;
+        DistributionFitter::Target m_fitTarget;
         double m_x0 = 0;
         double m_sigma = 0;
         double m_lambda = 0;
         bool m_ready = false;
+        bool m_warmStarted = false;
         bool m_anomaly = false;
         size_t m_consecutiveHighPower = 0;
         size_t m_consecutiveLowPower = 0;
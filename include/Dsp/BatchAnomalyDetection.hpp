@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Dsp
+{
+    class AnomalyDetection;
+
+    // AnomalyDetection::isAnomaly() for many channels at once. Each entry
+    // holds a copy of one channel's fitted model (x0, sigma, lambda) and
+    // the same consecutive-sample hysteresis, stored as SoA arrays, so one
+    // process() call evaluates every channel's sample with the vectorised
+    // SpectralKernels::cauchyTail() and a branchless counter update.
+    // Entries start disarmed and never flag until setModel() arms them.
+    class BatchAnomalyDetection
+    {
+    public:
+        inline static const int32_t CONSECUTIVE_COUNT = 10;
+        inline static const float ALPHA = 0.05f;
+
+        // Disarms every entry and clears its state.
+        void reset(size_t size);
+
+        // Adopts a new fit for an entry and arms it. Hysteresis state
+        // carries over, as it does when AnomalyDetection refits.
+        void setModel(size_t index, double x0, double sigma, double lambda);
+        void setModel(size_t index, const AnomalyDetection &anomDet);
+        void disarm(size_t index);
+
+        // Evaluates samples[i] against entry i and returns the number of
+        // anomalous entries. `size` must match reset().
+        size_t process(const float *samples, size_t size, float alpha = ALPHA);
+
+        bool isAnomaly(size_t index) const;
+        size_t getSize() const;
+        size_t getAnomalyCount() const;
+
+        // One bit per entry, entry i at mask[i / 64] bit (i % 64).
+        const std::vector<uint64_t> &getMask() const;
+
+    private:
+        size_t m_size = 0;
+        size_t m_anomalyCount = 0;
+
+        std::vector<float> m_x0;
+        std::vector<float> m_sigma;
+        std::vector<float> m_lambda;
+        std::vector<float> m_tail;
+        std::vector<int32_t> m_armed;
+        std::vector<int32_t> m_high;
+        std::vector<int32_t> m_low;
+        std::vector<int32_t> m_state;
+        std::vector<uint64_t> m_mask;
+    };
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+#include <cstddef>
+
+#include <fftw3.h>
+
+#include "Dsp/FramePool.hpp"
+#include "Dsp/SampleFormat.hpp"
+
+namespace Dsp
+{
+    // Critically sampled polyphase filter bank: splits a complex stream at
+    // fs into M channels of fs / M, each decimated by M. Channel k is
+    // centred on k * fs / M (channels at or above M / 2 are the negative
+    // frequencies). Every M input samples cost M * tapsPerChannel
+    // multiply-adds plus one M-point FFT, instead of M separate mixers and
+    // filters. The prototype is a Blackman-windowed sinc with unity DC gain,
+    // so a tone keeps its amplitude in its channel; adjacent channels
+    // overlap at their edges, as in any maximally decimated bank.
+    class Channelizer
+    {
+    public:
+        inline static const size_t DEFAULT_TAPS_PER_CHANNEL = 8;
+
+        // Input blocks whose M-point FFTs run as one batched plan.
+        inline static const size_t BATCH_BLOCKS = 32;
+
+        Channelizer(size_t channelCount, size_t tapsPerChannel = DEFAULT_TAPS_PER_CHANNEL);
+
+        Channelizer(const Channelizer &) = delete;
+        Channelizer &operator=(const Channelizer &) = delete;
+
+        // Consumes `count` input samples and writes the decimated output of
+        // channel k to out[k * stride + i]. Input left over from a partial
+        // block is kept for the next call. Returns the number of samples
+        // written per channel, at most outputCapacity(count) <= stride.
+        size_t process(const std::complex<float> *in, size_t count, std::complex<float> *out, size_t stride);
+
+        // As above for samples in a native format, converted one batch of
+        // blocks at a time.
+        size_t process(const void *in, const SampleFormat &format, size_t count, std::complex<float> *out, size_t stride);
+
+        size_t outputCapacity(size_t count) const;
+        size_t getChannelCount() const;
+
+        // Offset of channel k from the wideband centre frequency.
+        static double channelOffset(size_t channel, size_t channelCount, double sampleRate);
+
+        void reset();
+
+    private:
+        void processBlock(const std::complex<float> *block, std::complex<float> *out, size_t stride);
+
+        // Pushes one block of M inputs through the delay lines and writes
+        // the M branch outputs.
+        void filterBlock(const std::complex<float> *block, std::complex<float> *branch);
+        void scatter(const std::complex<float> *spectrum, std::complex<float> *out, size_t stride) const;
+
+        size_t m_channelCount;
+        size_t m_taps;
+
+        // Branch-major prototype: m_coefficients[p * m_taps + t] = h[p + t * M].
+        std::vector<float> m_coefficients;
+
+        // Per-branch delay lines, each stored twice back to back so the
+        // window starting at m_linePos is always contiguous.
+        IqFrame m_lines;
+        size_t m_linePos = 0;
+
+        IqFrame m_pending;
+        size_t m_pendingCount = 0;
+
+        IqFrame m_converted;
+        // BATCH_BLOCKS blocks of branch outputs and their spectra.
+        IqFrame m_branch;
+        IqFrame m_spectrum;
+        fftwf_plan m_plan;
+        fftwf_plan m_batchPlan;
+    };
+}
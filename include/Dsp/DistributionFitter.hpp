@@ -0,0 +1,76 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+#include "Model/CauchyParams.hpp"
+
+namespace Dsp
+{
+    // Process-wide background worker that fits the skew (lambda) of an
+    // AnomalyDetection model on a snapshot of its samples. Finished fits
+    // are published to the requesting Target through an atomic pointer
+    // exchange, so the DSP thread picks them up without taking a lock.
+    class DistributionFitter
+    {
+    public:
+        class Target
+        {
+        public:
+            Target();
+            // A copy is a different model: it never receives fits submitted
+            // for the original.
+            Target(const Target &);
+            Target &operator=(const Target &);
+
+            // Returns the latest finished fit, if any, and clears it.
+            std::unique_ptr<Model::CauchyParams> take();
+
+        private:
+            friend class DistributionFitter;
+
+            struct Slot
+            {
+                std::atomic<Model::CauchyParams *> pending{nullptr};
+                ~Slot();
+            };
+
+            std::shared_ptr<Slot> m_slot;
+        };
+
+        static DistributionFitter &instance();
+
+        // Queues a fit. A fit still queued for the same target is replaced
+        // by the newer snapshot.
+        void submit(Target &target, std::vector<double> &&samples, double x0, double sigma, double lambda);
+
+    private:
+        struct Job
+        {
+            std::shared_ptr<Target::Slot> slot;
+            std::vector<double> samples;
+            double x0;
+            double sigma;
+            double lambda;
+        };
+
+        DistributionFitter();
+        ~DistributionFitter();
+
+        DistributionFitter(const DistributionFitter &) = delete;
+        DistributionFitter &operator=(const DistributionFitter &) = delete;
+
+        void workerThread();
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<Job> m_jobs;
+        bool m_stopping = false;
+        std::thread m_worker;
+    };
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <fftw3.h>
+
+namespace Dsp
+{
+    // Process-wide cache of FFTW plans keyed by (size, direction, alignment,
+    // batch, placement, threads). Plans are created once with the configured planner
+    // flags and shared by every PowerSpectralDensity with the same FFT size;
+    // the cache owns them. Plans are meant for fftwf_execute_dft on new
+    // arrays.
+    class FftPlanCache
+    {
+    public:
+        static FftPlanCache &instance();
+
+        // A batch plan transforms `batch` contiguous transforms of `size`
+        // points in one call, transform b at offset b * size. In-place plans
+        // must be executed with in == out. Plans for more than one thread
+        // split each execution across FFTW's own threads; without
+        // fftw3f_threads the count is ignored.
+        fftwf_plan get(size_t size, int direction, bool aligned, size_t batch = 1, bool inPlace = false, size_t threads = 1);
+
+        // Whether the library was built against fftw3f_threads.
+        static bool threadsSupported();
+
+        // Applies to plans created after the call. FFTW_ESTIMATE by default;
+        // FFTW_MEASURE/FFTW_PATIENT are cheap once wisdom has been loaded.
+        void setPlannerFlags(unsigned flags);
+        unsigned getPlannerFlags();
+
+        bool loadWisdom(const std::string &fileName);
+        bool saveWisdom(const std::string &fileName);
+
+        size_t size();
+
+    private:
+        struct Key
+        {
+            size_t size;
+            int direction;
+            bool aligned;
+            size_t batch;
+            bool inPlace;
+            size_t threads;
+
+            bool operator<(const Key &rhs) const
+            {
+                if (size != rhs.size)
+                {
+                    return size < rhs.size;
+                }
+                if (direction != rhs.direction)
+                {
+                    return direction < rhs.direction;
+                }
+                if (aligned != rhs.aligned)
+                {
+                    return aligned < rhs.aligned;
+                }
+                if (batch != rhs.batch)
+                {
+                    return batch < rhs.batch;
+                }
+                if (inPlace != rhs.inPlace)
+                {
+                    return inPlace < rhs.inPlace;
+                }
+                return threads < rhs.threads;
+            }
+        };
+
+        FftPlanCache();
+        ~FftPlanCache();
+
+        FftPlanCache(const FftPlanCache &) = delete;
+        FftPlanCache &operator=(const FftPlanCache &) = delete;
+
+        std::mutex m_mutex;
+        std::map<Key, fftwf_plan> m_plans;
+        unsigned m_plannerFlags = FFTW_ESTIMATE;
+        bool m_threadsInitialised = false;
+    };
+}
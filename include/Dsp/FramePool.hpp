@@ -0,0 +1,144 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <vector>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace Dsp
+{
+    // Process-wide pool of 64-byte aligned sample buffers, recycled by byte
+    // size. A Frame owns its buffer and hands it back to the pool when it is
+    // destroyed, so loops that re-acquire the same sizes (a retune between a
+    // known set of FFT lengths, a restart) stop touching the heap once every
+    // size has been seen. The alignment satisfies FFTW's aligned plans and
+    // full cache lines for the SIMD kernels.
+    class FramePool
+    {
+    public:
+        inline static const size_t ALIGNMENT = 64;
+
+        template <typename T>
+        class Frame
+        {
+        public:
+            Frame() = default;
+
+            ~Frame()
+            {
+                reset();
+            }
+
+            Frame(Frame &&other) noexcept : m_data(std::exchange(other.m_data, nullptr)),
+                                            m_size(std::exchange(other.m_size, 0)),
+                                            m_bytes(std::exchange(other.m_bytes, 0)) {}
+
+            Frame &operator=(Frame &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    reset();
+                    m_data = std::exchange(other.m_data, nullptr);
+                    m_size = std::exchange(other.m_size, 0);
+                    m_bytes = std::exchange(other.m_bytes, 0);
+                }
+                return *this;
+            }
+
+            Frame(const Frame &) = delete;
+            Frame &operator=(const Frame &) = delete;
+
+            T *data() const
+            {
+                return m_data;
+            }
+
+            size_t size() const
+            {
+                return m_size;
+            }
+
+            T &operator[](size_t i) const
+            {
+                return m_data[i];
+            }
+
+            T *begin() const
+            {
+                return m_data;
+            }
+
+            T *end() const
+            {
+                return m_data + m_size;
+            }
+
+            explicit operator bool() const
+            {
+                return m_data != nullptr;
+            }
+
+            // Returns the buffer to the pool and leaves the frame empty.
+            void reset()
+            {
+                if (m_data != nullptr)
+                {
+                    FramePool::instance().give(m_data, m_bytes);
+                    m_data = nullptr;
+                    m_size = 0;
+                    m_bytes = 0;
+                }
+            }
+
+        private:
+            friend class FramePool;
+
+            Frame(T *data, size_t size, size_t bytes) : m_data(data), m_size(size), m_bytes(bytes) {}
+
+            T *m_data = nullptr;
+            size_t m_size = 0;
+            size_t m_bytes = 0;
+        };
+
+        static FramePool &instance();
+
+        // Contents of a recycled frame are unspecified; callers that need a
+        // defined state must fill it.
+        template <typename T>
+        Frame<T> acquire(size_t count)
+        {
+            size_t bytes = roundUp(count * sizeof(T));
+            return Frame<T>(static_cast<T *>(take(bytes)), count, bytes);
+        }
+
+        // Pre-allocates `count` buffers able to hold `bytes` each.
+        void reserve(size_t bytes, size_t count);
+
+        // Number of buffers ever allocated from the heap; flat in steady state.
+        size_t getAllocationCount();
+        size_t getFreeCount();
+
+    private:
+        FramePool() = default;
+        ~FramePool() = delete;
+
+        FramePool(const FramePool &) = delete;
+        FramePool &operator=(const FramePool &) = delete;
+
+        static size_t roundUp(size_t bytes);
+
+        void *take(size_t bytes);
+        void give(void *data, size_t bytes);
+
+        std::mutex m_mutex;
+        std::map<size_t, std::vector<void *>> m_free;
+        size_t m_allocationCount = 0;
+    };
+
+    typedef FramePool::Frame<std::complex<float>> IqFrame;
+    typedef FramePool::Frame<float> RealFrame;
+    typedef FramePool::Frame<uint8_t> ByteFrame;
+}
@@ -1,36 +1,124 @@
 #pragma once
 
+#include <array>
+#include <memory>
 #include <vector>
 #include <complex>
 
 #include <fftw3.h>
 
+#include "Dsp/FramePool.hpp"
+#include "Dsp/SampleFormat.hpp"
+
 namespace Dsp
 {
+    class WorkerPool;
+
     class PowerSpectralDensity
     {
     public:
         PowerSpectralDensity();
         ~PowerSpectralDensity();
 
+        // Copies the configuration; Welch state starts over in the copy.
+        PowerSpectralDensity(const PowerSpectralDensity &other);
+        PowerSpectralDensity &operator=(const PowerSpectralDensity &other);
+
         static void toFile(const char* fileName, double cf, double bw, float* arr, size_t size);
 
         void computeRealPsd(const std::complex<float>* fft, float* real, float sampleRate);
 
         double computeAvgPower(const std::complex<float>* iqSamples);
+        static double computeAvgPower(const std::complex<float>* iqSamples, size_t count);
 
         void execute(std::complex<float>* in, std::complex<float>* out);
 
+        // Converts one frame from `format`, windows and transforms it in a
+        // single pass over the input, which is left untouched.
+        void execute(const void* samples, const SampleFormat& format, std::complex<float>* out);
+
+        // Batched forms for `frames` contiguous frames, transformed with one
+        // plan_many call instead of one call per frame. Spectrum f lands at
+        // out[f * fftSize]. The in-place form windows and transforms inOut.
+        void executeBatch(const void* samples, const SampleFormat& format, size_t frames, std::complex<float>* out);
+        void executeBatch(std::complex<float>* inOut, size_t frames);
+
+        // Adds |X|^2 of every frame's spectrum to power[0, fftSize), in FFT
+        // bin order, for averaging without keeping the spectra.
+        void executeBatchPower(const void* samples, const SampleFormat& format, size_t frames, float* power);
+
+        // Plans the transforms executeBatch() needs for `frames` frames into
+        // aligned buffers, so an FFTW_MEASURE planner runs at setup rather
+        // than on the first block. Welch batches are planned by setWelch().
+        void prepareBatch(size_t frames);
+
+        // Welch averaging over a contiguous IQ stream: segments of m_fftSize
+        // samples overlapping by `overlap` (0 <= overlap < 1) are windowed and
+        // transformed, and every `averageCount` segments one averaged PSD is
+        // emitted. Returns the number of averaged spectra completed during
+        // the call; `real` holds the most recent one.
+        void setWelch(size_t averageCount, float overlap);
+        size_t welch(const std::complex<float>* samples, size_t count, float* real, float sampleRate);
+        size_t welch(const void* samples, const SampleFormat& format, size_t count, float* real, float sampleRate);
+
         size_t getFftSize() const;
 
         void setFftSize(double bandwidthHz);
 
+        // Opt-in multi-threaded transforms for FFT sizes or rates one core
+        // cannot keep up with. With fftw3f_threads every plan runs on
+        // `threads` FFTW threads; otherwise the batched forms split their
+        // frames across a pool of that many threads, so single-frame calls
+        // stay on the caller. Output order is unchanged either way. 1, the
+        // default, transforms on the calling thread only.
+        void setThreadCount(size_t threads);
+        size_t getThreadCount() const;
+
     private:
-        static void rotate(float* arr, size_t size);
-        static void swap(float& a, float& b);
-        void hanningWindow(std::complex<float>* in);
+        static std::shared_ptr<const std::vector<float>> hanningWindow(size_t size);
+        void resetWelch();
+
+        fftwf_plan plan(const std::complex<float>* in, const std::complex<float>* out);
+        fftwf_plan batchPlan(const std::complex<float>* in, const std::complex<float>* out, size_t frames);
+        void accumulatePower(const std::complex<float>* spectra, size_t frames, float* power) const;
+        void executeSplit(const void* samples, const SampleFormat* format, size_t frames, std::complex<float>* out);
+
+        struct BatchPlan
+        {
+            fftwf_plan plan = nullptr;
+            size_t frames = 0;
+            bool aligned = false;
+            bool inPlace = false;
+        };
 
-        fftwf_plan m_plan;
+        // Callers alternate between a few batch sizes, such as the Welch
+        // average and a whole block, so a handful are kept to skip the
+        // shared cache's lock; the oldest is replaced on a miss.
+        inline static const size_t BATCH_PLAN_SLOTS = 4;
+
+        fftwf_plan m_alignedPlan;
+        fftwf_plan m_unalignedPlan;
+        std::array<BatchPlan, BATCH_PLAN_SLOTS> m_batchPlans;
+        size_t m_nextBatchPlan = 0;
         size_t m_fftSize;
+        std::shared_ptr<const std::vector<float>> m_window;
+
+        size_t m_welchAverageCount = 1;
+        float m_welchOverlap = 0.0f;
+        size_t m_welchHop = 0;
+        size_t m_welchFill = 0;
+        size_t m_welchFrames = 0;
+        IqFrame m_welchSegment;
+        // The segments of one average, transformed together in place.
+        IqFrame m_welchBatch;
+        // Windowed input of execute() from a native format.
+        IqFrame m_work;
+        // Spectra of executeBatchPower(), grown on demand.
+        IqFrame m_batchWork;
+        RealFrame m_welchAccum;
+
+        size_t m_threads = 1;
+        // Only when FFTW cannot thread the plans itself.
+        std::unique_ptr<WorkerPool> m_workers;
     };
-}
\ No newline at end of file
+}
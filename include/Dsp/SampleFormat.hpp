@@ -0,0 +1,56 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+namespace Dsp
+{
+    // Layout of interleaved IQ samples as a device delivers them. Integer
+    // samples are widened to complex<float> times `scale`, normally
+    // 1 / full scale, so every format lands in the units the driver's own
+    // CF32 conversion would produce and calibrated models stay valid.
+    struct SampleFormat
+    {
+        enum class Type
+        {
+            CF32,
+            CS16,
+            CS8,
+            CU8 // Offset binary, centred on 127.5
+        };
+
+        Type type = Type::CF32;
+        float scale = 1.0f;
+
+        size_t bytesPerSample() const
+        {
+            switch (type)
+            {
+            case Type::CS16:
+                return 2 * sizeof(int16_t);
+            case Type::CS8:
+                return 2 * sizeof(int8_t);
+            case Type::CU8:
+                return 2 * sizeof(uint8_t);
+            default:
+                return sizeof(std::complex<float>);
+            }
+        }
+
+        const char *name() const
+        {
+            switch (type)
+            {
+            case Type::CS16:
+                return "CS16";
+            case Type::CS8:
+                return "CS8";
+            case Type::CU8:
+                return "CU8";
+            default:
+                return "CF32";
+            }
+        }
+    };
+}
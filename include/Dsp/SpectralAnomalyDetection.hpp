@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace Dsp
+{
+    // Per-bin anomaly detector for PSD frames (dB). Every bin keeps an
+    // exponentially weighted noise-floor mean and variance; a bin is hot
+    // when it sits more than THRESHOLD_SIGMA deviations (and at least
+    // MIN_EXCESS_DB) above its floor, and flips to anomalous after
+    // CONSECUTIVE_COUNT hot frames, mirroring AnomalyDetection. Statistics
+    // only adapt while a bin is quiet so a carrier is not absorbed into
+    // the floor. All state is stored as SoA arrays and the per-frame pass
+    // uses integer masks instead of branches so it vectorises.
+    class SpectralAnomalyDetection
+    {
+    public:
+        inline static const float SMOOTHING = 0.01f;
+        inline static const float THRESHOLD_SIGMA = 4.0f;
+        inline static const float MIN_EXCESS_DB = 3.0f;
+        inline static const int32_t CONSECUTIVE_COUNT = 3;
+        inline static const size_t WARMUP_FRAMES = 64;
+
+        // Processes one frame and returns the number of anomalous bins.
+        size_t process(const float *psdDb, size_t size);
+
+        bool isReady() const;
+        bool hasChanged() const;
+        size_t getSize() const;
+        size_t getAnomalyCount() const;
+
+        // One bit per bin, bin i at mask[i / 64] bit (i % 64).
+        const std::vector<uint64_t> &getMask() const;
+
+        // Contiguous runs of anomalous bins as [first, last] pairs.
+        std::vector<std::pair<size_t, size_t>> getRanges() const;
+
+        void reset(size_t size);
+
+    private:
+        size_t m_size = 0;
+        size_t m_frames = 0;
+        size_t m_anomalyCount = 0;
+        bool m_changed = false;
+
+        std::vector<float> m_mean;
+        std::vector<float> m_variance;
+        std::vector<int32_t> m_high;
+        std::vector<int32_t> m_low;
+        std::vector<int32_t> m_state;
+        std::vector<uint64_t> m_mask;
+    };
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+
+#include "Dsp/SampleFormat.hpp"
+
+namespace Dsp
+{
+    // Hot-path kernels for PowerSpectralDensity. The dispatched entry points
+    // pick an AVX2 or NEON implementation at runtime when available; the
+    // *Scalar variants are the reference implementations they are checked
+    // against.
+    class SpectralKernels
+    {
+    public:
+        // in[i] *= window[i]
+        static void applyWindow(std::complex<float> *in, const float *window, size_t size);
+
+        // out[i] = in[i] * format.scale, widening integer samples. For CF32
+        // `in` may alias `out`.
+        static void convert(const void *in, const SampleFormat &format, std::complex<float> *out, size_t size);
+
+        // out[i] = in[i] * format.scale * window[i]: convert() fused with
+        // applyWindow(), so raw samples are read once.
+        static void convertWindow(const void *in, const SampleFormat &format, const float *window, std::complex<float> *out, size_t size);
+        static void convertWindowScalar(const void *in, const SampleFormat &format, const float *window, std::complex<float> *out, size_t size);
+
+        // real = fftshift(10 * log10(scale * |fft|^2)), no sqrt.
+        static void powerDb(const std::complex<float> *fft, float *real, size_t size, float scale);
+        static void powerDbScalar(const std::complex<float> *fft, float *real, size_t size, float scale);
+
+        // real = fftshift(10 * log10(scale * power)) for already squared bins.
+        static void toDb(const float *power, float *real, size_t size, float scale);
+        static void toDbScalar(const float *power, float *real, size_t size, float scale);
+
+        // p[i] = 1 - F(x[i]) under the asymmetric Cauchy fit (x0[i],
+        // sigma[i], lambda[i]) of AnomalyDetection::cdf(), with a polynomial
+        // atan and no branches on the sign of the residual.
+        static void cauchyTail(const float *x, const float *x0, const float *sigma, const float *lambda, float *p, size_t size);
+        static void cauchyTailScalar(const float *x, const float *x0, const float *sigma, const float *lambda, float *p, size_t size);
+
+        static const char *isa();
+
+        // Upper bound of |powerDb - powerDbScalar| and |toDb - toDbScalar|
+        // in dB, enforced by the kernel_check test.
+        inline static const float TOLERANCE_DB = 1e-3f;
+
+        // Upper bound of |cauchyTail - cauchyTailScalar|.
+        inline static const float TOLERANCE_TAIL = 1e-5f;
+    };
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+namespace Dsp
+{
+    // Fixed set of threads that split one range of work between them and
+    // the caller. run() hands each participant one contiguous slice and
+    // returns once all of them are done, so results written by index keep
+    // their order. One run() at a time; it is not reentrant.
+    class WorkerPool
+    {
+    public:
+        typedef std::function<void(size_t begin, size_t end)> Task;
+
+        // `threads` includes the caller, so 1 starts no workers.
+        explicit WorkerPool(size_t threads);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        void run(size_t count, const Task &task);
+
+        size_t getThreadCount() const;
+
+    private:
+        void workerMain(size_t index);
+        void slice(size_t participant, size_t &begin, size_t &end) const;
+
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        uint64_t m_generation = 0;
+        size_t m_pending = 0;
+        bool m_stopping = false;
+
+        // The current run(); only read by workers between wake and done.
+        const Task *m_task = nullptr;
+        size_t m_count = 0;
+    };
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+
+#include "Dsp/SampleFormat.hpp"
+#include "DataStructure/MpscQueue.hpp"
+
+struct io_uring;
+
+namespace Io
+{
+    // Triggered recorder for raw IQ. Every pushed block lands in an in-memory
+    // ring that always holds the last preTriggerS seconds; trigger() turns
+    // that history plus the next postTriggerS seconds into
+    // <prefix><time_ns>.sigmf-data, in the stream's native format, with a
+    // SigMF .sigmf-meta beside it. A trigger while recording extends the
+    // recording. A writer thread streams the ring to disk with aligned
+    // O_DIRECT writes, through io_uring when built with liburing, so the
+    // pushing thread never waits on I/O: if the disk falls behind, blocks
+    // are dropped and the recording notes the gap as a new capture segment.
+    // push() and trigger() must be called from a single thread.
+    class IqRecorder
+    {
+    public:
+        // O_DIRECT granularity of offsets, lengths and buffers.
+        inline static const size_t ALIGNMENT = 4096;
+        inline static const size_t WRITE_BYTES = 1 << 20;
+        inline static const unsigned QUEUE_DEPTH = 8;
+        // Pushes further than this from the previous block's expected time
+        // start a new capture segment.
+        inline static const int64_t GAP_TOLERANCE_NS = 5000000;
+
+        IqRecorder(const std::string &prefix, const Dsp::SampleFormat &format, double sampleRate,
+                   double preTriggerS, double postTriggerS);
+        ~IqRecorder();
+
+        IqRecorder(const IqRecorder &) = delete;
+        IqRecorder &operator=(const IqRecorder &) = delete;
+
+        // `count` samples in the configured format, the first captured at
+        // timeNs (system clock) while tuned to `frequency`.
+        void push(const void *samples, size_t count, int64_t timeNs, double frequency);
+
+        // Marks the newest pushed sample as a trigger. Returns true when this
+        // starts a new recording rather than extending the current one.
+        bool trigger();
+
+        bool isRecording() const;
+        uint64_t getRecordingCount() const;
+        uint64_t getFailedCount() const;
+        uint64_t getDroppedSampleCount() const;
+
+    private:
+        inline static const uint64_t NONE = ~uint64_t(0);
+
+        // Byte positions count every byte ever pushed; ring offset is
+        // position % m_capacity.
+        struct Event
+        {
+            enum class Type
+            {
+                Segment,
+                Trigger
+            };
+
+            Type type;
+            uint64_t position;
+            int64_t timeNs;
+            double frequency;
+        };
+
+        struct Write
+        {
+            uint64_t position;
+            size_t bytes;
+            bool done;
+        };
+
+        bool start(uint64_t head);
+
+        void writerMain();
+        void drainEvents();
+        void open(uint64_t start);
+        bool submit(uint64_t position, size_t bytes);
+        bool reap(bool wait);
+        void close(uint64_t end, bool failed);
+        void writeMetadata(uint64_t start, uint64_t end, const std::string &fileName) const;
+        int64_t timeAt(uint64_t position) const;
+
+        std::string m_prefix;
+        Dsp::SampleFormat m_format;
+        double m_sampleRate;
+        size_t m_preBytes;
+        size_t m_postBytes;
+        size_t m_sampleBytes;
+
+        uint8_t *m_ring = nullptr;
+        size_t m_capacity = 0;
+
+        // m_head is written by the pushing thread. m_tail is the oldest byte
+        // the writer still needs, NONE when idle; the pushing thread sets it
+        // to open a recording and never overwrites past it. m_end is the
+        // position the current recording stops at, 0 when there is none;
+        // the pushing thread extends it and the writer closes it with a CAS.
+        std::atomic<uint64_t> m_head{0};
+        std::atomic<uint64_t> m_tail{NONE};
+        std::atomic<uint64_t> m_end{0};
+        std::atomic<bool> m_running{true};
+
+        std::atomic<uint64_t> m_recordings{0};
+        std::atomic<uint64_t> m_failed{0};
+        std::atomic<uint64_t> m_droppedSamples{0};
+
+        // Pushing thread only.
+        double m_lastFrequency = -1;
+        int64_t m_expectedNs = 0;
+        bool m_gap = true;
+        bool m_pendingTrigger = false;
+
+        Ds::MpscQueue<Event> m_events;
+        std::mutex m_wakeMutex;
+        std::condition_variable m_wake;
+
+        // Writer thread only.
+        std::deque<Event> m_segments;
+        std::vector<uint64_t> m_triggers;
+        std::deque<Write> m_inFlight;
+        uint64_t m_start = 0;
+        uint64_t m_submitted = 0;
+        int m_fd = -1;
+        std::string m_fileName;
+        struct io_uring *m_uring = nullptr;
+
+        std::thread m_writer;
+    };
+}
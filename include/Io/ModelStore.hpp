@@ -0,0 +1,78 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <optional>
+
+#include "Model/CauchyParams.hpp"
+
+namespace Io
+{
+    // Calibrated detector models keyed by (device, frequency, gain), kept
+    // in a small versioned text file so a restart can resume detection
+    // without recalibrating. Frequencies are matched to the hertz and gains
+    // to 0.1 dB. Shared by every device in the process; all methods are
+    // thread-safe.
+    class ModelStore
+    {
+    public:
+        inline static const uint32_t VERSION = 1;
+
+        // Minimum spacing of the saves made by flush().
+        inline static const std::chrono::seconds SAVE_INTERVAL{30};
+
+        struct Entry
+        {
+            Model::CauchyParams params;
+            uint64_t samples;
+            int64_t updatedS;
+        };
+
+        explicit ModelStore(const std::string &fileName);
+
+        // Replaces the in-memory models with the file's. Returns false if
+        // the file is missing or written by another version, leaving the
+        // store empty.
+        bool load();
+
+        // Writes every model, replacing the file atomically. The file is
+        // written outside the lock find() and put() take.
+        bool save();
+
+        // Saves if a model has changed and SAVE_INTERVAL has passed since
+        // the last save. Call periodically from a thread that may block on
+        // disk, not a capture or DSP thread. Returns false if a save failed.
+        bool flush();
+
+        std::optional<Entry> find(const std::string &device, double frequency, double gain) const;
+
+        // Records a model in memory; flush() or save() persists it.
+        void put(const std::string &device, double frequency, double gain, const Model::CauchyParams &params, uint64_t samples);
+
+        size_t size() const;
+
+    private:
+        struct Key
+        {
+            std::string device;
+            int64_t frequencyHz;
+            int64_t gainDeciDb;
+
+            bool operator<(const Key &rhs) const;
+        };
+
+        static Key makeKey(const std::string &device, double frequency, double gain);
+        bool write(const std::map<Key, Entry> &entries) const;
+
+        std::string m_fileName;
+        mutable std::mutex m_mutex;
+        std::map<Key, Entry> m_entries;
+        std::chrono::steady_clock::time_point m_lastSave;
+        bool m_dirty = false;
+        // Serialises save(); taken before m_mutex, never while holding it.
+        std::mutex m_saveMutex;
+    };
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace Io
+{
+    // Binary telemetry ring in a memory-mapped file. The file holds a fixed
+    // FileHeader followed by slotCount slots, each a SlotHeader plus
+    // binCapacity float32 bins. A single writer updates slots under a
+    // per-slot seqlock (sequence is odd while a slot is being written) and
+    // bumps writeCount after each frame, so readers can mmap the file and
+    // pick up the latest frame without any parsing or locking.
+    class SpectrumRing
+    {
+    public:
+        inline static const uint32_t MAGIC = 0x47525344; // "DSRG"
+        inline static const uint32_t VERSION = 1;
+
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t headerSize;
+            uint32_t slotSize;
+            uint32_t slotCount;
+            uint32_t binCapacity;
+            uint64_t writeCount;
+            uint8_t reserved[32];
+        };
+
+        struct SlotHeader
+        {
+            uint64_t sequence;
+            int64_t timestampNs;
+            double centerFrequency;
+            double bandwidth;
+            uint32_t binCount;
+            uint8_t reserved[28];
+        };
+
+        SpectrumRing(const std::string &fileName, uint32_t binCapacity, uint32_t slotCount);
+        ~SpectrumRing();
+
+        SpectrumRing(const SpectrumRing &) = delete;
+        SpectrumRing &operator=(const SpectrumRing &) = delete;
+
+        void write(double centerFrequency, double bandwidth, const float *bins, size_t count, int64_t timestampNs);
+
+        uint32_t getBinCapacity() const;
+
+    private:
+        int m_fd = -1;
+        uint8_t *m_map = nullptr;
+        size_t m_mapSize = 0;
+        uint32_t m_binCapacity;
+        uint32_t m_slotCount;
+        uint32_t m_slotSize;
+    };
+}
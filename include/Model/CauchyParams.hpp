@@ -0,0 +1,11 @@
+#pragma once
+
+namespace Model
+{
+    struct CauchyParams
+    {
+        double x0;
+        double sigma;
+        double lambda;
+    };
+}
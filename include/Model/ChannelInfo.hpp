@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Model
+{
+    struct ChannelInfo
+    {
+        double frequency;
+        double bandwidth;
+        bool calibrated;
+        bool anomaly;
+        double x0;
+        double sigma;
+        double lambda;
+        uint64_t frames;
+        uint64_t anomalies;
+        uint64_t visits;
+        double revisitP50Ms;
+        double revisitP99Ms;
+    };
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Model
+{
+    // A chunk of whole FFT frames from one or more reads, `size` samples in
+    // the stream's native format. timeNs is the system-clock time of the
+    // first sample.
+    struct alignas(64) IqBlock
+    {
+        void *samples = nullptr;
+        size_t size = 0;
+        int64_t timeNs = 0;
+        int flags = 0;
+    };
+}
@@ -2,6 +2,7 @@
 
 #include "Dsp/AnomalyDetection.hpp"
 #include "Dsp/PowerSpectralDensity.hpp"
+#include "Dsp/SpectralAnomalyDetection.hpp"
 
 namespace Model
 {
@@ -12,6 +13,7 @@ namespace Model
         double bandwidth;
         Dsp::PowerSpectralDensity psd;
         Dsp::AnomalyDetection anomDet;
+        Dsp::SpectralAnomalyDetection binDet;
 
         bool operator==(const SdrRoundRobinConfig &rhs)
         {
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "StreamClock.hpp"
+#include "PipelineMetrics.hpp"
+#include "Dsp/FramePool.hpp"
+#include "Dsp/SampleFormat.hpp"
+
+namespace SoapySDR
+{
+    class Device;
+    class Stream;
+}
+
+namespace Sdr
+{
+    // Reads a stream in chunks of several frames and hands the frames out
+    // one at a time, pointing into the chunk buffer rather than copying, so
+    // a dwell of N frames costs one readStream() call instead of N. A
+    // partial frame left by a short read is carried into the next chunk.
+    // Every frame is stamped with the system-clock time of its first
+    // sample, derived from the device timestamp when there is one.
+    class BurstReader
+    {
+    public:
+        // `samples` is in the stream's format.
+        struct Frame
+        {
+            const void *samples;
+            size_t size;
+            int64_t timeNs;
+            int flags;
+        };
+
+        inline static const long READ_TIMEOUT_US = 100000;
+
+        BurstReader(SoapySDR::Device &device,
+                    SoapySDR::Stream *stream,
+                    const Dsp::SampleFormat &format,
+                    PipelineMetrics &metrics,
+                    std::atomic<uint64_t> &samplesRead);
+
+        // Frames of frameSize samples, read in chunks of chunkSamples
+        // rounded up to whole frames. Drops anything buffered.
+        void setGeometry(size_t frameSize, size_t chunkSamples, double sampleRate);
+
+        // The next frame, reading a new chunk when the buffered frames run
+        // out. Valid until the next call. Returns false when the read fails.
+        bool next(Frame &frame);
+
+        // Up to maxFrames contiguous frames as one Frame of n * frameSize
+        // samples, for batched transforms. Returns n, 0 when the read fails.
+        size_t next(Frame &frame, size_t maxFrames);
+
+        // Reads and drops `count` samples, buffered ones first. Returns the
+        // number dropped, which is short only if a read failed.
+        size_t discard(size_t count);
+
+        // Drops buffered samples, e.g. ones captured before a retune.
+        void reset();
+
+        size_t getChunkSize() const;
+
+    private:
+        bool fill();
+
+        SoapySDR::Device &m_device;
+        SoapySDR::Stream *m_stream;
+        PipelineMetrics &m_metrics;
+        std::atomic<uint64_t> &m_samplesRead;
+        StreamClock m_clock;
+        size_t m_sampleBytes;
+
+        Dsp::ByteFrame m_buffer;
+        size_t m_frameSize = 0;
+        size_t m_chunkSize = 0;
+        double m_sampleRate = 0.0;
+
+        // Valid samples are [m_head, m_tail), counted in samples rather
+        // than bytes; m_bufferTimeNs is the time of
+        // m_buffer[0] and m_bufferFlags the flags of the read that filled it.
+        size_t m_head = 0;
+        size_t m_tail = 0;
+        int64_t m_bufferTimeNs = 0;
+        int m_bufferFlags = 0;
+    };
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "Dsp/AnomalyDetection.hpp"
+#include "Dsp/PowerSpectralDensity.hpp"
+#include "Dsp/SpectralAnomalyDetection.hpp"
+
+namespace Sdr
+{
+    // The channels one tuner monitors, addressed by stable slot indices.
+    // State read on every dwell (frequency, anomaly flag, model parameters,
+    // counters) lives in parallel arrays, so scanning hundreds of channels
+    // walks a few contiguous cache lines instead of chasing nodes. The
+    // heavy DSP objects (plans, Welch buffers, sample windows) live in
+    // separately allocated cold records. Removing a channel frees its slot
+    // for reuse without moving any other channel, so indices and Detectors
+    // references held by the processing thread stay valid across inserts
+    // and removals. Not synchronised: mutate only from the thread that
+    // processes the channels.
+    class ChannelTable
+    {
+    public:
+        inline static const size_t NONE = static_cast<size_t>(-1);
+
+        struct Detectors
+        {
+            Dsp::PowerSpectralDensity psd;
+            Dsp::AnomalyDetection anomDet;
+            Dsp::SpectralAnomalyDetection binDet;
+            // When the initial calibration last took a sample, so samples
+            // taken on separate visits stay spaced in time.
+            std::chrono::steady_clock::time_point lastCalibrationSample;
+        };
+
+        // Returns the slot of the new channel, or of the existing one if the
+        // frequency is already monitored.
+        size_t insert(double frequency, double bandwidth);
+
+        // Returns false if the slot is not in use.
+        bool remove(size_t index);
+
+        size_t find(double frequency) const;
+        bool contains(size_t index) const;
+
+        size_t size() const;
+        bool empty() const;
+
+        // Live slots, densely packed for iteration. Order is not stable.
+        const std::vector<size_t> &active() const;
+
+        double getFrequency(size_t index) const;
+        double getBandwidth(size_t index) const;
+
+        bool isAnomalous(size_t index) const;
+        void setAnomalous(size_t index, bool anomalous);
+        uint64_t getAnomalyCount(size_t index) const;
+
+        void addFrames(size_t index, uint64_t frames);
+        uint64_t getFrameCount(size_t index) const;
+
+        // Copies the channel detector's current fit into the hot arrays.
+        void syncModel(size_t index);
+        double getX0(size_t index) const;
+        double getSigma(size_t index) const;
+        double getLambda(size_t index) const;
+
+        Detectors &detectors(size_t index);
+        const Detectors &detectors(size_t index) const;
+
+    private:
+        // Hot state, one element per slot.
+        std::vector<double> m_frequency;
+        std::vector<double> m_bandwidth;
+        std::vector<double> m_x0;
+        std::vector<double> m_sigma;
+        std::vector<double> m_lambda;
+        std::vector<uint64_t> m_anomalyCount;
+        std::vector<uint64_t> m_frames;
+        std::vector<uint8_t> m_anomaly;
+        std::vector<uint8_t> m_live;
+
+        // Cold state, one allocation per slot.
+        std::vector<std::unique_ptr<Detectors>> m_detectors;
+
+        std::vector<size_t> m_free;
+        std::vector<size_t> m_active;
+        std::vector<size_t> m_position;
+    };
+}
@@ -1,10 +1,22 @@
 #pragma once
 
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
 #include "SdrBase.hpp"
 
+#include "Model/IqBlock.hpp"
+#include "Model/SdrRoundRobinConfig.hpp"
+#include "Dsp/FramePool.hpp"
+#include "Dsp/SpectralAnomalyDetection.hpp"
+#include "Dsp/BatchAnomalyDetection.hpp"
+#include "DataStructure/SpscRingBuffer.hpp"
+
 namespace Dsp
 {
     class PowerSpectralDensity;
+    class Channelizer;
 }
 
 namespace SoapySDR
@@ -17,7 +29,15 @@ namespace Sdr
     class LimeSdrMini2 : public SdrBase
     {
     public:
-        LimeSdrMini2();
+        inline static const size_t RING_BLOCK_COUNT = 64;
+        inline static const size_t WELCH_AVERAGE_COUNT = 8;
+        inline static const float WELCH_OVERLAP = 0.5f;
+        // Narrowest channel setChannelCount() may produce: a 4-bin FFT.
+        inline static const double MIN_CHANNEL_RATE_HZ = 62500;
+
+        LimeSdrMini2(size_t index = 0);
+        LimeSdrMini2(std::unique_ptr<SoapySDR::Device> device);
+        ~LimeSdrMini2() override;
 
         void processThread() override;
 
@@ -26,8 +46,47 @@ namespace Sdr
                        double gain = GAIN_DBI,
                        double sampleRate = -9999) override;
 
+        // Splits the capture into `count` channels of sampleRate / count,
+        // each with its own power and per-bin anomaly detection alongside
+        // the wideband pipeline. 0 disables. Counts that would make channels
+        // narrower than MIN_CHANNEL_RATE_HZ are clamped. Set before run().
+        void setChannelCount(size_t count);
+        size_t getChannelCount() const;
+
+        // Transforms on `threads` threads for wideband configurations whose
+        // FFT rate one core cannot sustain; see
+        // PowerSpectralDensity::setThreadCount. 1 by default. Set before
+        // run().
+        void setFftThreads(size_t threads);
+        size_t getFftThreads() const;
+
+        // Every frame of the stream, sampleRate / fftSize.
+        double getRequiredFrameRate() const override;
+
+        uint64_t getOverrunCount() const;
+        uint64_t getUnderrunCount() const;
+        uint64_t getDroppedSampleCount() const;
+
     private:
+        void dspThread(size_t chunkSize);
+        void setupChannels(size_t blockSize);
+        void processChannels(const void *samples, size_t count, bool collect, bool refit);
+
         std::unique_ptr<Dsp::PowerSpectralDensity> m_psd;
         std::unique_ptr<Dsp::AnomalyDetection> m_anomDet;
+        Dsp::SpectralAnomalyDetection m_binDet;
+
+        size_t m_channelCount = 0;
+        std::unique_ptr<Dsp::Channelizer> m_channelizer;
+        std::vector<Model::SdrRoundRobinConfig> m_channels;
+        // Power detection of every channel, evaluated together; mirrors
+        // each channel's anomDet model.
+        Dsp::BatchAnomalyDetection m_channelDet;
+        Dsp::RealFrame m_channelPower;
+        Dsp::IqFrame m_channelOut;
+        Dsp::RealFrame m_channelPsd;
+        size_t m_channelStride = 0;
+
+        Ds::SpscRingBuffer<Model::IqBlock> m_ring;
     };
-}
\ No newline at end of file
+}
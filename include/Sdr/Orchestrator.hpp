@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "SdrBase.hpp"
+
+namespace Sdr
+{
+    // Owns a set of devices and runs each one on its own pinned capture and
+    // DSP threads, so adding a device adds cores instead of contention.
+    class Orchestrator
+    {
+    public:
+        struct DeviceReport
+        {
+            std::string driver;
+            bool running;
+            uint64_t samplesRead;
+            uint64_t framesProcessed;
+            double samplesPerSecond;
+            double framesPerSecond;
+            // 0 when the device does not transform every frame.
+            double requiredFramesPerSecond;
+        };
+
+        ~Orchestrator();
+
+        // Returns the added device so the caller can keep configuring it.
+        SdrBase &add(std::unique_ptr<SdrBase> device, const SdrBase::ThreadConfig &config = {});
+
+        // Devices whose output prefix is already taken by an earlier device
+        // are given one derived from their device id first, so no two
+        // devices map the same telemetry ring.
+        void start();
+        void stop();
+
+        size_t size() const;
+
+        // Throughput of each device since the previous report() call.
+        std::vector<DeviceReport> report();
+        void logReport();
+
+        // Writes every device's counters and stage latency histograms as
+        // JSON, replacing the file atomically so readers never see a torn
+        // dump.
+        void dumpMetrics(const char *fileName) const;
+
+    private:
+        void assignOutputPrefixes();
+
+        struct Entry
+        {
+            std::unique_ptr<SdrBase> device;
+            SdrBase::Stats lastStats;
+        };
+
+        std::vector<Entry> m_entries;
+        std::chrono::time_point<std::chrono::steady_clock> m_lastReport;
+    };
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#include "DataStructure/LatencyHistogram.hpp"
+
+namespace Sdr
+{
+    // Per-device hot-path instrumentation: one latency histogram per
+    // processing stage and counters for readStream outcomes. Recording is
+    // wait-free, and stage timers only read the clock on one call in
+    // TIMING_SAMPLE_PERIOD, which keeps the cost well under 1% of a frame
+    // so it can stay enabled in production. snapshot() may be called from
+    // any thread.
+    class PipelineMetrics
+    {
+    public:
+        enum class Stage
+        {
+            Read,      // readStream
+            Fft,       // window + FFT (+ Welch)
+            Power,     // average power and PSD
+            Detection, // model update and anomaly tests
+            Refit,     // rolling sample collection and refits
+            Output     // telemetry publishing
+        };
+
+        enum class Counter
+        {
+            Overflows,
+            Timeouts,
+            StreamErrors,
+            ShortReads,
+            DroppedSamples,
+            Retunes,
+            SettleSamples // read and discarded while the tuner settles
+        };
+
+        inline static const size_t STAGE_COUNT = 6;
+        inline static const size_t COUNTER_COUNT = 7;
+        inline static const uint32_t TIMING_SAMPLE_PERIOD = 8;
+
+        struct StageSnapshot
+        {
+            uint64_t count;
+            double meanNs;
+            uint64_t p50Ns;
+            uint64_t p99Ns;
+            uint64_t p999Ns;
+            uint64_t maxNs;
+        };
+
+        struct Snapshot
+        {
+            std::array<StageSnapshot, STAGE_COUNT> stages;
+            std::array<uint64_t, COUNTER_COUNT> counters;
+        };
+
+        // Times the enclosing scope into one stage. Rare, expensive calls
+        // pass sampled = false so they are always recorded.
+        class ScopedTimer
+        {
+        public:
+            ScopedTimer(PipelineMetrics &metrics, Stage stage, bool sampled = true);
+            ~ScopedTimer();
+
+            ScopedTimer(const ScopedTimer &) = delete;
+            ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+        private:
+            PipelineMetrics &m_metrics;
+            Stage m_stage;
+            bool m_enabled;
+            std::chrono::steady_clock::time_point m_start;
+        };
+
+        void record(Stage stage, uint64_t nanoseconds);
+
+        // True on every TIMING_SAMPLE_PERIOD-th call for a stage. Each stage
+        // is timed from a single thread, so the tick needs no RMW.
+        bool sample(Stage stage);
+        void add(Counter counter, uint64_t value = 1);
+        uint64_t get(Counter counter) const;
+
+        // Classifies a readStream() result: negative codes count as
+        // overflow, timeout or stream error, and fewer samples than
+        // requested as a short read.
+        void recordRead(int ret, size_t requested, int flags);
+
+        Snapshot snapshot() const;
+
+        static const char *stageName(Stage stage);
+        static const char *counterName(Counter counter);
+
+        // Appends the snapshot as a JSON object.
+        static void toJson(std::string &out, const Snapshot &snapshot);
+
+    private:
+        std::array<Ds::LatencyHistogram, STAGE_COUNT> m_stages;
+        std::array<std::atomic<uint64_t>, COUNTER_COUNT> m_counters{};
+        std::array<std::atomic<uint32_t>, STAGE_COUNT> m_ticks{};
+    };
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <complex>
+#include <cstdint>
+
+#include <SoapySDR/Device.hpp>
+
+namespace Sdr
+{
+    // SoapySDR device that plays back a recorded IQ file or synthesises a
+    // signal, so LimeSdrMini2 and RtlSdrV4 can run without hardware. Streams
+    // are paced at a multiple of real time (or not at all), and retunes block
+    // for a configurable latency the way a PLL relock would.
+    class ReplayDevice : public SoapySDR::Device
+    {
+    public:
+        inline static const size_t STREAM_MTU = 16384;
+        inline static const size_t NOISE_TABLE_SIZE = 1 << 16;
+
+        enum class Source
+        {
+            File,  // Recorded CF32, CS16, CS8 or CU8 IQ, memory mapped
+            Tone,  // Continuous tone plus noise
+            Burst, // Tone keyed on and off plus noise
+            Noise  // Complex Gaussian noise only
+        };
+
+        struct Config
+        {
+            Source source = Source::Noise;
+
+            std::string path;
+            // Format of the file, and the native format the device reports
+            // for every source; streams may still be opened in any format.
+            std::string format = "CF32";
+            bool loop = true;
+
+            // Absolute RF frequency of the tone; it only shows up when it
+            // falls inside the tuned band.
+            double toneFrequency = 0;
+            float toneAmplitude = 0.5f;
+            float noiseAmplitude = 0.01f;
+            double burstPeriodS = 1.0;
+            double burstDurationS = 0.1;
+
+            // Multiple of real time to pace the stream at; 0 runs unpaced.
+            double speed = 1.0;
+            std::chrono::microseconds retuneLatency{1000};
+
+            unsigned seed = 1;
+        };
+
+        explicit ReplayDevice(const Config &config);
+        ~ReplayDevice() override;
+
+        ReplayDevice(const ReplayDevice &) = delete;
+        ReplayDevice &operator=(const ReplayDevice &) = delete;
+
+        std::string getDriverKey() const override;
+        std::string getHardwareKey() const override;
+
+        std::vector<std::string> getStreamFormats(const int direction, const size_t channel) const override;
+        std::string getNativeStreamFormat(const int direction, const size_t channel, double &fullScale) const override;
+        SoapySDR::Stream *setupStream(const int direction,
+                                      const std::string &format,
+                                      const std::vector<size_t> &channels = std::vector<size_t>(),
+                                      const SoapySDR::Kwargs &args = SoapySDR::Kwargs()) override;
+        void closeStream(SoapySDR::Stream *stream) override;
+        size_t getStreamMTU(SoapySDR::Stream *stream) const override;
+        int activateStream(SoapySDR::Stream *stream, const int flags = 0, const long long timeNs = 0, const size_t numElems = 0) override;
+        int deactivateStream(SoapySDR::Stream *stream, const int flags = 0, const long long timeNs = 0) override;
+        int readStream(SoapySDR::Stream *stream,
+                       void *const *buffs,
+                       const size_t numElems,
+                       int &flags,
+                       long long &timeNs,
+                       const long timeoutUs = 100000) override;
+
+        void setGain(const int direction, const size_t channel, const double value) override;
+        double getGain(const int direction, const size_t channel) const override;
+        void setFrequency(const int direction, const size_t channel, const double frequency,
+                          const SoapySDR::Kwargs &args = SoapySDR::Kwargs()) override;
+        double getFrequency(const int direction, const size_t channel) const override;
+        void setSampleRate(const int direction, const size_t channel, const double rate) override;
+        double getSampleRate(const int direction, const size_t channel) const override;
+        void setBandwidth(const int direction, const size_t channel, const double bw) override;
+        double getBandwidth(const int direction, const size_t channel) const override;
+
+        // Samples skipped while retuning an active stream.
+        uint64_t getRetuneDroppedSamples() const;
+
+    private:
+        size_t readFile(std::complex<float> *out, size_t count);
+        void synthesise(std::complex<float> *out, size_t count);
+        void pace();
+
+        Config m_config;
+
+        const uint8_t *m_file = nullptr;
+        size_t m_fileBytes = 0;
+        size_t m_fileSamples = 0;
+        size_t m_fileOffset = 0;
+        size_t m_sampleBytes = 0;
+
+        std::vector<std::complex<float>> m_noise;
+        std::vector<std::complex<float>> m_encodeBuffer;
+        uint32_t m_noiseSeed;
+        std::complex<double> m_phasor{1.0, 0.0};
+
+        double m_gain = 0;
+        double m_frequency = 0;
+        double m_sampleRate = 1e6;
+        double m_bandwidth = 1e6;
+
+        bool m_active = false;
+        uint64_t m_sampleCount = 0;
+        uint64_t m_retuneDropped = 0;
+        std::chrono::time_point<std::chrono::steady_clock> m_streamStart;
+    };
+}
@@ -1,14 +1,18 @@
 #pragma once
 
-#include <map>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <vector>
+#include <complex>
 
 #include "SdrBase.hpp"
+#include "BurstReader.hpp"
+#include "ChannelTable.hpp"
+#include "SweepScheduler.hpp"
 
-#include "Dsp/AnomalyDetection.hpp"
-#include "Dsp/PowerSpectralDensity.hpp"
-
-#include "DataStructure/CircularLinkedList.hpp"
+#include "Model/ChannelInfo.hpp"
+#include "DataStructure/MpscQueue.hpp"
 
 namespace SoapySDR
 {
@@ -16,11 +20,6 @@ namespace SoapySDR
     class Stream;
 }
 
-namespace Model
-{
-    struct SdrRoundRobinConfig;
-}
-
 namespace Sdr
 {
     class RtlSdrV4 : public SdrBase
@@ -29,18 +28,73 @@ namespace Sdr
         inline static const double BANDWIDTH_HZ = 2.4e6;
         inline static const double SAMPLE_RATE_HZ = 3.2e6;
 
-        RtlSdrV4();
+        // Reads per dwell: enough for isAnomaly() to change state.
+        inline static const size_t DWELL_READS = Dsp::AnomalyDetection::CONSECUTIVE_COUNT + 1;
+
+        // Samples discarded after every retune while the PLL settles,
+        // about 5 ms at the default rate.
+        inline static const size_t DEFAULT_SETTLE_SAMPLES = 16384;
+
+        // How often an idle capture thread checks for new channels.
+        inline static const std::chrono::milliseconds COMMAND_POLL_INTERVAL{10};
+
+        // How often listChannels() is refreshed between applied changes.
+        // Each refresh walks every channel's revisit histogram.
+        inline static const std::chrono::milliseconds CHANNEL_PUBLISH_INTERVAL{1000};
+
+        RtlSdrV4(size_t index = 0);
+        RtlSdrV4(std::unique_ptr<SoapySDR::Device> device);
+        ~RtlSdrV4() override;
 
         void processThread() override;
 
+        // Thread-safe channel control. Changes are queued and applied by
+        // the capture thread between dwells, so they take effect within one
+        // dwell; calibrated models on the other channels are kept.
+        void addFrequency(double frequency);
+        void removeFrequency(double frequency);
         void setFrequencies(const std::vector<double> &frequencies);
 
+        // Snapshot of the channels, refreshed every CHANNEL_PUBLISH_INTERVAL,
+        // on every applied change and on exit. Empty until the capture
+        // thread has started.
+        std::vector<Model::ChannelInfo> listChannels() const;
+
+        void setSettleSamples(size_t samples);
+
+        // Per-channel visit counts and revisit latency. Read after stop().
+        const SweepScheduler &getScheduler() const;
+
         void configure(double frequency,
                        double bandwidth,
                        double gain = GAIN_DBI,
                        double sampleRate = -9999) override;
 
     private:
-        Ds::CircularLinkedList<Model::SdrRoundRobinConfig> m_configList;
+        struct Command
+        {
+            enum class Type
+            {
+                Add,
+                Remove
+            };
+
+            Type type;
+            double frequency;
+        };
+
+        void applyCommands();
+        void publishChannels();
+        void discardSettling(BurstReader &reader);
+        void logRevisitLatency() const;
+
+        ChannelTable m_table;
+        SweepScheduler m_scheduler;
+        size_t m_current = 0;
+        size_t m_settleSamples = DEFAULT_SETTLE_SAMPLES;
+
+        Ds::MpscQueue<Command> m_commands;
+        std::atomic<std::shared_ptr<const std::vector<Model::ChannelInfo>>> m_channelSnapshot;
+        SweepScheduler::Clock::time_point m_lastChannelPublish;
     };
-}
\ No newline at end of file
+}
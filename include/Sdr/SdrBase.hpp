@@ -3,16 +3,31 @@
 #include <atomic>
 #include <memory>
 #include <chrono>
+#include <string>
+#include <thread>
+#include <cstdint>
+
+#include "PipelineMetrics.hpp"
+#include "Dsp/SampleFormat.hpp"
 
 namespace Dsp
 {
     class PowerSpectralDensity;
     class AnomalyDetection;
+    class SpectralAnomalyDetection;
 }
 
 namespace SoapySDR
 {
     class Device;
+    class Stream;
+}
+
+namespace Io
+{
+    class SpectrumRing;
+    class ModelStore;
+    class IqRecorder;
 }
 
 namespace Sdr
@@ -22,13 +37,63 @@ namespace Sdr
     public:
         inline static const double GAIN_DBI = 0;
 
-        SdrBase(const std::string &driver);
+        // CPU to pin each thread to (-1 leaves it unpinned) and the
+        // SCHED_FIFO priority to run them at (0 keeps the default policy).
+        struct ThreadConfig
+        {
+            int captureCpu = -1;
+            int dspCpu = -1;
+            int realtimePriority = 0;
+        };
+
+        struct Stats
+        {
+            uint64_t samplesRead;
+            uint64_t framesProcessed;
+        };
+
+        // Opens the index-th enumerated device of the given driver, so
+        // several dongles of the same kind can run side by side.
+        SdrBase(const std::string &driver, size_t index = 0);
+
+        // Wraps an already constructed device, such as a ReplayDevice,
+        // instead of enumerating hardware.
+        SdrBase(const std::string &driver, std::unique_ptr<SoapySDR::Device> device);
         virtual ~SdrBase();
 
+        // Starts processThread() on a joinable capture thread.
         virtual void run();
 
+        // Signals the threads to exit without waiting for them.
+        void requestStop();
+
+        // Signals the threads to exit and joins them.
         void stop();
 
+        bool isRunning() const;
+
+        void setThreadConfig(const ThreadConfig &config);
+
+        Stats getStats() const;
+
+        // Frames per second the DSP must transform to keep up with the
+        // stream, to hold framesProcessed against. 0 for devices that do
+        // not transform every frame, such as a sweeping RTL.
+        virtual double getRequiredFrameRate() const;
+        PipelineMetrics::Snapshot getMetrics() const;
+        const std::string &getDriver() const;
+
+        // Identifies the physical device in the model store: the driver
+        // plus the serial number when enumeration reports one, else the
+        // enumeration index. Override for wrapped devices.
+        void setDeviceId(const std::string &id);
+        const std::string &getDeviceId() const;
+
+        // Calibrated models are loaded from and saved to `store`, so a
+        // detector with a stored model for its (device, frequency, gain)
+        // skips calibration. Set before run().
+        void setModelStore(std::shared_ptr<Io::ModelStore> store);
+
         double getGain() const;
         double getFrequency() const;
         double getBandwidth() const;
@@ -41,14 +106,83 @@ namespace Sdr
 
         virtual void processThread() = 0;
 
+        // Write the legacy comma-separated *.txt telemetry instead of the
+        // memory-mapped *.bin rings. Debug only; it costs more than the FFT.
+        void setTextOutput(bool enabled);
+
+        // Prepended to every telemetry file name, so several devices in one
+        // process do not map the same ring. Orchestrator::start() replaces
+        // a prefix another device already uses. Set before run().
+        void setOutputPrefix(const std::string &prefix);
+        const std::string &getOutputPrefix() const;
+
+        // Samples requested per readStream() call, rounded up to whole FFT
+        // frames. 0 lets the device pick: the stream MTU for the Lime, one
+        // dwell capped at the MTU for the RTL. Set before run().
+        void setReadChunk(size_t samples);
+
+        // Capture in the device's native sample format (CS16, CS8 or CU8)
+        // and widen it in the DSP, instead of having the driver hand over
+        // CF32 at up to four times the memory traffic. On by default; set
+        // before run().
+        void setNativeFormat(bool enabled);
+
+        // Keep the last preTriggerS seconds of raw IQ in memory and, when
+        // the detector fires, write them and the next postTriggerS seconds
+        // to <prefix>iq_<time_ns>.sigmf-data. 0 disables; set before run().
+        void setIqRecording(double preTriggerS, double postTriggerS);
+
     protected:
+        enum class ThreadRole
+        {
+            Capture,
+            Dsp
+        };
+
         inline static const long long TIME_BETWEEN_ROLLING_SAMPLE_COLLECT_MS = 10;
         inline static const long long TIME_BETWEEN_ROLLING_SAMPLE_DIST_PROCESS_MS = 10000;
+        inline static const long long TIME_BETWEEN_CALIBRATION_SAMPLE_COLLECT_MS = 20;
+
+        inline static const uint32_t PSD_RING_SLOTS = 8;
+        inline static const uint32_t AVG_POWER_RING_SLOTS = 4096;
+        inline static const uint32_t DISTRIBUTION_RING_SLOTS = 16;
 
         bool isTimeToCollectSample();
         bool isTimeToProcessSampleDistribution();
-
+        // Spaces the samples of an initial calibration without sleeping.
+        bool isTimeToCollectCalibrationSample();
+
+        // Applies the configured affinity and priority to the calling thread.
+        void applyThreadConfig(ThreadRole role);
+
+        // Sets up the RX stream in the native format when enabled and
+        // supported, else CF32, and records it in m_sampleFormat.
+        SoapySDR::Stream *setupRxStream();
+
+        // timeNs is the system-clock time of the frame's first sample.
+        void publishAvgPower(float avgPower, int64_t timeNs);
+        void publishPsd(float *psd, size_t size, int64_t timeNs);
+        void publishDistribution(const Dsp::AnomalyDetection &anomDet);
+        // Warm-starts the detector from the model store. Returns false when
+        // there is no store or no model, and the detector must calibrate.
+        bool loadModel(Dsp::AnomalyDetection &anomDet, double frequency);
+        void saveModel(const Dsp::AnomalyDetection &anomDet, double frequency);
+
+        // `sampleRate` is the rate the bins were computed at; the default
+        // uses the device rate.
+        void logBinAnomalies(const Dsp::SpectralAnomalyDetection &binDet, double frequency, double sampleRate = -9999);
+
+        // Feed the IQ recorder, when enabled, from the processing thread:
+        // every block as it is consumed, and a trigger on each detection.
+        void recordIq(const void *samples, size_t count, int64_t timeNs, double frequency);
+        void triggerRecording();
+
+        bool m_madeBySoapy;
         std::atomic<bool> m_running;
+        std::atomic<bool> m_textOutput;
+        std::atomic<uint64_t> m_samplesRead;
+        std::atomic<uint64_t> m_framesProcessed;
+        PipelineMetrics m_metrics;
         std::unique_ptr<SoapySDR::Device> m_device;
 
         double m_gain = -9999;
@@ -57,9 +191,30 @@ namespace Sdr
         double m_sampleRate = -9999;
 
         std::string m_driver;
+        std::string m_deviceId;
+        std::string m_outputPrefix;
+        size_t m_readChunk = 0;
+        bool m_nativeFormat = true;
+        Dsp::SampleFormat m_sampleFormat;
+        double m_recordPreS = 0;
+        double m_recordPostS = 0;
+
+        std::shared_ptr<Io::ModelStore> m_modelStore;
+
+        std::unique_ptr<Io::SpectrumRing> m_psdRing;
+        std::unique_ptr<Io::SpectrumRing> m_avgPowerRing;
+        std::unique_ptr<Io::SpectrumRing> m_distributionRing;
+        std::unique_ptr<Io::IqRecorder> m_recorder;
 
         std::chrono::time_point<std::chrono::system_clock> m_currentTimeS;
         std::chrono::time_point<std::chrono::system_clock> m_lastSampleCollectedS;
         std::chrono::time_point<std::chrono::system_clock> m_lastDistributionProcessedS;
+        std::chrono::time_point<std::chrono::system_clock> m_lastCalibrationSampleS;
+
+    private:
+        void threadMain();
+
+        ThreadConfig m_threadConfig;
+        std::thread m_thread;
     };
 }
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Sdr
+{
+    // Turns readStream() timestamps into system-clock nanoseconds for the
+    // first sample of a read. The first read carrying SOAPY_SDR_HAS_TIME
+    // anchors the device clock to the host clock; later reads keep the
+    // device's sample-accurate spacing and only re-anchor if the two drift
+    // more than RESYNC_THRESHOLD_NS apart. Reads without a device time fall
+    // back to the host clock at return minus the read's duration.
+    class StreamClock
+    {
+    public:
+        inline static const int64_t RESYNC_THRESHOLD_NS = 50000000;
+
+        int64_t toSystemNs(long long deviceNs, int flags, size_t samples, double sampleRate);
+
+        // Forgets the anchor, e.g. when the stream is restarted.
+        void reset();
+
+    private:
+        bool m_anchored = false;
+        int64_t m_offsetNs = 0;
+    };
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "DataStructure/LatencyHistogram.hpp"
+
+namespace Sdr
+{
+    // Decides which frequency a single tuner dwells on next. Channels are
+    // stride scheduled: each visit advances a channel's pass by 1 / weight,
+    // and only channels less than one quiet visit ahead of the lowest pass
+    // are eligible. Anomalous and recently active channels weigh more, so
+    // they come round more often. Among the eligible channels the one
+    // nearest the current frequency wins, which turns a quiet sweep into a
+    // serpentine of short retunes. Channels are keyed by the caller's
+    // stable slot index (see ChannelTable). Used from the capture thread
+    // only.
+    class SweepScheduler
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        inline static const size_t NONE = static_cast<size_t>(-1);
+
+        inline static const double QUIET_WEIGHT = 1.0;
+        inline static const double ACTIVE_WEIGHT = 2.0;
+        inline static const double ANOMALOUS_WEIGHT = 4.0;
+
+        // How long a channel counts as recently active after an anomaly.
+        inline static const std::chrono::seconds ACTIVE_HOLD{30};
+
+        // Starts scheduling slot `index`, replacing whatever it held before.
+        void add(size_t index, double frequency);
+        void remove(size_t index);
+
+        size_t size() const;
+        bool empty() const;
+
+        // Ends the dwell on the current channel and picks the next one.
+        // Returns the current index again when no other channel is due, and
+        // NONE when there are no channels.
+        size_t next(Clock::time_point now);
+        size_t current() const;
+
+        // Reports whether the channel was anomalous at the end of its dwell.
+        void setAnomalous(size_t index, bool anomalous, Clock::time_point now);
+
+        double getFrequency(size_t index) const;
+        double getWeight(size_t index, Clock::time_point now) const;
+        uint64_t getVisitCount(size_t index) const;
+
+        // Nanoseconds from the end of one dwell on a channel to the start
+        // of the next, i.e. how long it went unobserved.
+        Ds::LatencyHistogram::Snapshot getRevisitLatency(size_t index) const;
+
+    private:
+        struct Channel
+        {
+            double frequency = 0.0;
+            double pass = 0.0;
+            bool live = false;
+            bool anomalous = false;
+            bool active = false;
+            bool visited = false;
+            uint64_t visits = 0;
+            Clock::time_point lastAnomaly;
+            Clock::time_point lastLeft;
+            std::unique_ptr<Ds::LatencyHistogram> revisit;
+        };
+
+        double minPass() const;
+
+        std::vector<Channel> m_channels;
+        size_t m_size = 0;
+        size_t m_current = NONE;
+        double m_lastFrequency = 0.0;
+        double m_direction = 1.0;
+    };
+}
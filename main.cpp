@@ -1,3 +1,5 @@
+#include <chrono>
+#include <memory>
 #include <cstdlib>
 #include <thread>
 
@@ -5,26 +7,81 @@
 
 #include "Sdr/RtlSdrV4.hpp"
 #include "Sdr/LimeSdrMini2.hpp"
+#include "Sdr/Orchestrator.hpp"
+#include "Dsp/FftPlanCache.hpp"
+#include "Io/ModelStore.hpp"
+
+static const char *FFTW_WISDOM_FILE = "fftw_wisdom.dat";
+static const std::chrono::seconds RUN_DURATION(6000);
+static const std::chrono::seconds REPORT_INTERVAL(10);
+static const char *METRICS_FILE = "metrics.json";
+static const char *MODEL_STORE_FILE = "models.txt";
 
 int main()
 {
     try
     {
-        // Sdr::RtlSdrV4 rtlSdr;
+        Dsp::FftPlanCache &planCache = Dsp::FftPlanCache::instance();
+        if (planCache.loadWisdom(FFTW_WISDOM_FILE) == true)
+        {
+            LOG(SOAPY_SDR_INFO, "Loaded FFTW wisdom from %s", FFTW_WISDOM_FILE);
+        }
+        planCache.setPlannerFlags(FFTW_MEASURE);
+
+        auto modelStore = std::make_shared<Io::ModelStore>(MODEL_STORE_FILE);
+        if (modelStore->load() == true)
+        {
+            LOG(SOAPY_SDR_INFO, "Loaded %zu calibrated models from %s", modelStore->size(), MODEL_STORE_FILE);
+        }
+
+        Sdr::Orchestrator orchestrator;
+
+        // Each device gets its own cores: capture on one, DSP on the next.
+        // auto &rtlSdr = static_cast<Sdr::RtlSdrV4 &>(orchestrator.add(std::make_unique<Sdr::RtlSdrV4>(0), {4, 4, 0}));
+        // rtlSdr.setOutputPrefix("rtlsdr_");
+        // rtlSdr.setModelStore(modelStore);
         // rtlSdr.setFrequencies({461e6});
         // rtlSdr.setFrequencies({460e6, 470e6, 480e6, 490e6, 500e6});
-        // rtlSdr.run();
 
-        Sdr::LimeSdrMini2 limeSdr;
+        auto &limeSdr = orchestrator.add(std::make_unique<Sdr::LimeSdrMini2>(), {2, 3, 0});
         limeSdr.configure(58e6, 30e6);
-        limeSdr.run();
-        
-        std::this_thread::sleep_for(std::chrono::seconds(6000));
-        
-        // rtlSdr.stop();
-        limeSdr.stop();
-
-        std::this_thread::sleep_for(std::chrono::seconds(5));
+        limeSdr.setModelStore(modelStore);
+        // static_cast<Sdr::LimeSdrMini2 &>(limeSdr).setChannelCount(16);
+        // static_cast<Sdr::LimeSdrMini2 &>(limeSdr).setFftThreads(4);
+        // limeSdr.setIqRecording(1.0, 4.0);
+
+        orchestrator.start();
+
+        // Devices plan their batch geometries as they start, so this first
+        // save may miss some; the one after stop() has every plan.
+        if (planCache.saveWisdom(FFTW_WISDOM_FILE) == false)
+        {
+            LOG(SOAPY_SDR_WARNING, "Failed to save FFTW wisdom to %s", FFTW_WISDOM_FILE);
+        }
+
+        auto end = std::chrono::steady_clock::now() + RUN_DURATION;
+        while (std::chrono::steady_clock::now() < end)
+        {
+            std::this_thread::sleep_for(REPORT_INTERVAL);
+            orchestrator.logReport();
+            orchestrator.dumpMetrics(METRICS_FILE);
+            if (modelStore->flush() == false)
+            {
+                LOG(SOAPY_SDR_WARNING, "Failed to save calibrated models to %s", MODEL_STORE_FILE);
+            }
+        }
+
+        orchestrator.stop();
+
+        if (planCache.saveWisdom(FFTW_WISDOM_FILE) == false)
+        {
+            LOG(SOAPY_SDR_WARNING, "Failed to save FFTW wisdom to %s", FFTW_WISDOM_FILE);
+        }
+
+        if (modelStore->save() == false)
+        {
+            LOG(SOAPY_SDR_WARNING, "Failed to save calibrated models to %s", MODEL_STORE_FILE);
+        }
     }
     catch (std::runtime_error e)
     {
@@ -4,11 +4,19 @@ import time
 from collections import deque
 from scipy import stats
 
+import spectrum_ring
+
 # Maximum number of samples to keep in history
 MAX_HISTORY_SIZE = 250
 
 # Read data from file
 def read_avg_power_file(filename):
+    if filename.endswith('.bin'):
+        frame = spectrum_ring.read_latest(filename)
+        if frame is None or len(frame[3]) < 1:
+            return None, None, None
+        center_freq, bandwidth, _, values = frame
+        return center_freq, bandwidth, float(values[0])
     try:
         with open(filename, 'r') as f:
             lines = f.readlines()
@@ -53,7 +61,7 @@ plt.ion()  # Interactive mode
 fig, ax = plt.subplots(figsize=(7, 3))
 
 # Initial setup
-filename = 'build/avg_power_output.txt'
+filename = 'build/avg_power_output.bin'  # avg_power_output.txt when running with text output
 
 # Wait for valid data
 print("Waiting for data...")
@@ -4,8 +4,16 @@ import time
 from collections import deque
 from datetime import datetime
 
+import spectrum_ring
+
 # Read data from file
 def read_avg_power_file(filename):
+    if filename.endswith('.bin'):
+        frame = spectrum_ring.read_latest(filename)
+        if frame is None or len(frame[3]) < 1:
+            return None, None, None
+        center_freq, bandwidth, _, values = frame
+        return center_freq, bandwidth, float(values[0])
     try:
         with open(filename, 'r') as f:
             lines = f.readlines()
@@ -48,7 +56,7 @@ fig, ax = plt.subplots(figsize=(10, 4))
 line, = ax.plot([], [], linewidth=1.5, marker='o', markersize=2)
 
 # Initial setup
-filename = 'build/avg_power_output.txt'
+filename = 'build/avg_power_output.bin'  # avg_power_output.txt when running with text output
 
 # Wait for valid data
 print("Waiting for data...")
@@ -2,8 +2,16 @@ import matplotlib.pyplot as plt
 import numpy as np
 import time
 
+import spectrum_ring
+
 # Read data from file
 def read_psd_file(filename):
+    if filename.endswith('.bin'):
+        frame = spectrum_ring.read_latest(filename)
+        if frame is None or len(frame[3]) == 0:
+            return None, None, None, None
+        center_freq, bandwidth, _, values = frame
+        return center_freq, bandwidth, len(values), values
     try:
         with open(filename, 'r') as f:
             lines = f.readlines()
@@ -65,7 +73,7 @@ fig, ax = plt.subplots(figsize=(6, 3))
 line, = ax.plot([], [], linewidth=1)
 
 # Initial setup
-filename = 'build/psd_output.txt'
+filename = 'build/psd_output.bin'  # psd_output.txt when running with text output
 
 # Wait for valid data
 print("Waiting for data...")
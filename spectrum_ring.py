@@ -0,0 +1,80 @@
+import mmap
+import os
+import struct
+
+import numpy as np
+
+# Layout written by Io::SpectrumRing (include/Io/SpectrumRing.hpp)
+MAGIC = 0x47525344
+VERSION = 1
+FILE_HEADER = struct.Struct('<IIIIIIQ')
+SLOT_HEADER = struct.Struct('<QqddI')
+SLOT_HEADER_SIZE = 64
+
+_rings = {}
+
+
+class SpectrumRing:
+    def __init__(self, filename):
+        self.filename = filename
+        self.file = open(filename, 'rb')
+        self.inode = os.fstat(self.file.fileno()).st_ino
+        self.mm = mmap.mmap(self.file.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, version, self.header_size, self.slot_size, self.slot_count, self.bin_capacity, _ = \
+            FILE_HEADER.unpack_from(self.mm, 0)
+        if magic != MAGIC or version != VERSION:
+            self.close()
+            raise ValueError('not a spectrum ring')
+
+    def close(self):
+        self.mm.close()
+        self.file.close()
+
+    def stale(self):
+        try:
+            st = os.stat(self.filename)
+        except OSError:
+            return True
+        return st.st_ino != self.inode or st.st_size != len(self.mm)
+
+    def write_count(self):
+        return FILE_HEADER.unpack_from(self.mm, 0)[6]
+
+    def read(self, frame):
+        """Returns (center_freq, bandwidth, timestamp_ns, bins) for a frame
+        index, or None if it was overwritten or torn while reading."""
+        offset = self.header_size + (frame % self.slot_count) * self.slot_size
+        for _ in range(4):
+            seq, timestamp_ns, center_freq, bandwidth, count = SLOT_HEADER.unpack_from(self.mm, offset)
+            if seq & 1:
+                continue
+            bins = np.frombuffer(self.mm, dtype='<f4', count=count,
+                                 offset=offset + SLOT_HEADER_SIZE).copy()
+            if SLOT_HEADER.unpack_from(self.mm, offset)[0] == seq:
+                return center_freq, bandwidth, timestamp_ns, bins
+        return None
+
+    def read_latest(self):
+        count = self.write_count()
+        if count == 0:
+            return None
+        return self.read(count - 1)
+
+
+def open_ring(filename):
+    ring = _rings.get(filename)
+    if ring is not None and ring.stale():
+        ring.close()
+        ring = None
+    if ring is None:
+        ring = SpectrumRing(filename)
+        _rings[filename] = ring
+    return ring
+
+
+def read_latest(filename):
+    try:
+        return open_ring(filename).read_latest()
+    except (OSError, ValueError, struct.error):
+        _rings.pop(filename, None)
+        return None
@@ -1,18 +1,137 @@
 #include <math.h>
+#include <limits>
+#include <vector>
 #include <fstream>
 #include <iostream>
+#include <algorithm>
 
 #include "Dsp/AnomalyDetection.hpp"
 
 using namespace Dsp;
 
+namespace
+{
+    // Brent's method: golden-section search accelerated by parabolic
+    // interpolation, minimising f on [a, b] to within `tol`.
+    template <typename F>
+    double brent(F f, double a, double b, double tol, size_t maxIterations)
+    {
+        const double golden = 0.3819660112501051;
+
+        double x = a + golden * (b - a);
+        double w = x;
+        double v = x;
+        double fx = f(x);
+        double fw = fx;
+        double fv = fx;
+        double d = 0.0;
+        double e = 0.0;
+
+        for (size_t iter = 0; iter < maxIterations; iter++)
+        {
+            double m = 0.5 * (a + b);
+            double tol2 = 2.0 * tol;
+            if (fabs(x - m) <= tol2 - 0.5 * (b - a))
+            {
+                break;
+            }
+
+            bool parabolic = false;
+            if (fabs(e) > tol)
+            {
+                double r = (x - w) * (fx - fv);
+                double q = (x - v) * (fx - fw);
+                double p = (x - v) * q - (x - w) * r;
+                q = 2.0 * (q - r);
+                if (q > 0.0)
+                {
+                    p = -p;
+                }
+                else
+                {
+                    q = -q;
+                }
+                double previousStep = e;
+                e = d;
+                if (fabs(p) < fabs(0.5 * q * previousStep) && p > q * (a - x) && p < q * (b - x))
+                {
+                    d = p / q;
+                    double u = x + d;
+                    if (u - a < tol2 || b - u < tol2)
+                    {
+                        d = x < m ? tol : -tol;
+                    }
+                    parabolic = true;
+                }
+            }
+            if (parabolic == false)
+            {
+                e = (x < m ? b : a) - x;
+                d = golden * e;
+            }
+
+            double u = x + (fabs(d) >= tol ? d : (d > 0.0 ? tol : -tol));
+            double fu = f(u);
+
+            if (fu <= fx)
+            {
+                if (u < x)
+                {
+                    b = x;
+                }
+                else
+                {
+                    a = x;
+                }
+                v = w;
+                fv = fw;
+                w = x;
+                fw = fx;
+                x = u;
+                fx = fu;
+            }
+            else
+            {
+                if (u < x)
+                {
+                    a = u;
+                }
+                else
+                {
+                    b = u;
+                }
+                if (fu <= fw || w == x)
+                {
+                    v = w;
+                    fv = fw;
+                    w = u;
+                    fw = fu;
+                }
+                else if (fu <= fv || v == x || v == w)
+                {
+                    v = u;
+                    fv = fu;
+                }
+            }
+        }
+
+        return x;
+    }
+}
+
 void AnomalyDetection::pushSample(double sample)
 {
     m_samples.push_back(sample);
+    m_order.insert(sample);
 
     if (m_samples.size() > MAX_SIZE)
     {
+        m_order.erase(m_samples.front());
         m_samples.pop_front();
+    }
+
+    if (m_samples.size() > CALIBRATION_SIZE)
+    {
         m_ready = true;
     }
 }
@@ -22,6 +141,25 @@ bool AnomalyDetection::isReady() const
     return m_ready;
 }
 
+void AnomalyDetection::warmStart(const Model::CauchyParams &params)
+{
+    m_x0 = params.x0;
+    m_sigma = params.sigma;
+    m_lambda = params.lambda;
+    m_ready = true;
+    m_warmStarted = true;
+}
+
+bool AnomalyDetection::isWarming() const
+{
+    return m_warmStarted == true && m_samples.size() <= CALIBRATION_SIZE;
+}
+
+size_t AnomalyDetection::getSampleCount() const
+{
+    return m_samples.size();
+}
+
 bool AnomalyDetection::isAnomaly(double sample, double alpha)
 {
     double p = 1.0 - cdf(sample, m_x0, m_sigma, m_lambda);
@@ -56,28 +194,100 @@ void AnomalyDetection::processDistribution()
     if (m_samples.size() < 2)
         return;
 
-    std::vector<double> distribution(m_samples.begin(), m_samples.end());
-    std::sort(distribution.begin(), distribution.end());
+    refitLocationScale();
+
+    m_distribution.assign(m_samples.begin(), m_samples.end());
+    m_lambda = mle(m_distribution, m_x0, m_sigma, m_lambda);
+}
+
+void AnomalyDetection::requestRefit()
+{
+    if (m_samples.size() < 2 || isWarming())
+        return;
 
-    size_t n = distribution.size() - 1;
+    refitLocationScale();
+
+    std::vector<double> snapshot(m_samples.begin(), m_samples.end());
+    DistributionFitter::instance().submit(m_fitTarget, std::move(snapshot), m_x0, m_sigma, m_lambda);
+}
+
+bool AnomalyDetection::updateModel()
+{
+    std::unique_ptr<Model::CauchyParams> params = m_fitTarget.take();
+    if (params == nullptr)
+    {
+        return false;
+    }
+
+    m_x0 = params->x0;
+    m_sigma = params->sigma;
+    m_lambda = params->lambda;
+    return true;
+}
+
+void AnomalyDetection::refitLocationScale()
+{
+    if (m_order.size() < 2 || isWarming())
+        return;
+
+    size_t n = m_order.size() - 1;
     if (n % 2 == 0)
     {
-        m_x0 = (distribution[n / 2 - 1] + distribution[n / 2]) / 2.0;
+        m_x0 = (m_order.kth(n / 2 - 1) + m_order.kth(n / 2)) / 2.0;
     }
     else
     {
-        m_x0 = distribution[n / 2];
+        m_x0 = m_order.kth(n / 2);
     }
     size_t q1 = static_cast<size_t>(n * 0.25);
     size_t q3 = static_cast<size_t>(n * 0.75);
-    m_sigma = (distribution[q3] - distribution[q1]) / 2.0;
+    m_sigma = (m_order.kth(q3) - m_order.kth(q1)) / 2.0;
+}
 
-    m_lambda = mle(distribution, m_x0, m_sigma);
+double AnomalyDetection::getX0() const
+{
+    return m_x0;
+}
+
+double AnomalyDetection::getSigma() const
+{
+    return m_sigma;
+}
+
+double AnomalyDetection::getLambda() const
+{
+    return m_lambda;
+}
+
+double AnomalyDetection::mle(const std::vector<double> &samples, double x_0, double sigma, double initialLambda)
+{
+    const double lower = -1.0 + D_THETA;
+    const double upper = 1.0 - D_THETA;
+    auto f = [&](double lambda)
+    {
+        return nll(samples, x_0, sigma, lambda);
+    };
+
+    // Lambda drifts slowly between refits, so search a narrow bracket
+    // around the previous fit first and only fall back to the full range
+    // when the minimum sits on the bracket edge.
+    if (initialLambda > lower && initialLambda < upper)
+    {
+        double a = std::max(lower, initialLambda - MLE_WARM_START_SPAN);
+        double b = std::min(upper, initialLambda + MLE_WARM_START_SPAN);
+        double lambda = brent(f, a, b, MLE_TOLERANCE, MLE_MAX_ITERATIONS);
+        bool onLowerEdge = a > lower && lambda - a < 10.0 * MLE_TOLERANCE;
+        bool onUpperEdge = b < upper && b - lambda < 10.0 * MLE_TOLERANCE;
+        if (onLowerEdge == false && onUpperEdge == false)
+        {
+            return lambda;
+        }
+    }
 
-    toFile("cauchy_dist.txt");
+    return brent(f, lower, upper, MLE_TOLERANCE, MLE_MAX_ITERATIONS);
 }
 
-double AnomalyDetection::mle(const std::vector<double> &samples, double x_0, double sigma)
+double AnomalyDetection::mleGrid(const std::vector<double> &samples, double x_0, double sigma)
 {
     double bestLambda = D_THETA;
     double bestNll = std::numeric_limits<double>::infinity();
@@ -148,7 +358,7 @@ int AnomalyDetection::sgn(double x)
     }
 }
 
-void AnomalyDetection::toFile(const char *fileName)
+void AnomalyDetection::toFile(const char *fileName) const
 {
     std::string temp_file = std::string(fileName) + ".tmp";
     std::ofstream os(temp_file, std::ios::trunc);
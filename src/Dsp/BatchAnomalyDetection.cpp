@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "Dsp/BatchAnomalyDetection.hpp"
+#include "Dsp/AnomalyDetection.hpp"
+#include "Dsp/SpectralKernels.hpp"
+
+using namespace Dsp;
+
+static_assert(static_cast<size_t>(BatchAnomalyDetection::CONSECUTIVE_COUNT) == AnomalyDetection::CONSECUTIVE_COUNT,
+              "Batch hysteresis must match AnomalyDetection");
+
+namespace
+{
+    // Same update as AnomalyDetection::isAnomaly(), written with masks so
+    // the compiler vectorises it; disarmed entries stay at zero.
+    void updateEntries(const float *__restrict tail,
+                       const int32_t *__restrict armed,
+                       int32_t *__restrict high,
+                       int32_t *__restrict low,
+                       int32_t *__restrict state,
+                       size_t size,
+                       float alpha,
+                       int32_t consecutive)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            // All ones when the sample is in the tail, zero otherwise.
+            int32_t hot = armed[i] & -static_cast<int32_t>(tail[i] < alpha);
+
+            int32_t h = (high[i] + 1) & hot;
+            int32_t l = (low[i] + 1) & ~hot & armed[i];
+            h = h < consecutive ? h : consecutive;
+            l = l < consecutive ? l : consecutive;
+            high[i] = h;
+            low[i] = l;
+            state[i] = (h >= consecutive) | ((l < consecutive) & state[i] & armed[i]);
+        }
+    }
+}
+
+void BatchAnomalyDetection::reset(size_t size)
+{
+    m_size = size;
+    m_anomalyCount = 0;
+    // A harmless model for disarmed entries keeps the kernel finite.
+    m_x0.assign(size, 0.0f);
+    m_sigma.assign(size, 1.0f);
+    m_lambda.assign(size, 0.0f);
+    m_tail.assign(size, 1.0f);
+    m_armed.assign(size, 0);
+    m_high.assign(size, 0);
+    m_low.assign(size, 0);
+    m_state.assign(size, 0);
+    m_mask.assign((size + 63) / 64, 0);
+}
+
+void BatchAnomalyDetection::setModel(size_t index, double x0, double sigma, double lambda)
+{
+    if (index >= m_size)
+    {
+        throw std::runtime_error("Batch anomaly detection index out of range");
+    }
+    m_x0[index] = static_cast<float>(x0);
+    m_sigma[index] = static_cast<float>(sigma);
+    m_lambda[index] = static_cast<float>(lambda);
+    m_armed[index] = -1;
+}
+
+void BatchAnomalyDetection::setModel(size_t index, const AnomalyDetection &anomDet)
+{
+    setModel(index, anomDet.getX0(), anomDet.getSigma(), anomDet.getLambda());
+}
+
+void BatchAnomalyDetection::disarm(size_t index)
+{
+    if (index >= m_size)
+    {
+        throw std::runtime_error("Batch anomaly detection index out of range");
+    }
+    m_armed[index] = 0;
+    m_high[index] = 0;
+    m_low[index] = 0;
+    m_state[index] = 0;
+}
+
+size_t BatchAnomalyDetection::process(const float *samples, size_t size, float alpha)
+{
+    if (size != m_size)
+    {
+        throw std::runtime_error("Batch anomaly detection size mismatch");
+    }
+
+    SpectralKernels::cauchyTail(samples, m_x0.data(), m_sigma.data(), m_lambda.data(), m_tail.data(), size);
+    updateEntries(m_tail.data(), m_armed.data(), m_high.data(), m_low.data(), m_state.data(),
+                  size, alpha, CONSECUTIVE_COUNT);
+
+    size_t count = 0;
+    for (size_t word = 0; word < m_mask.size(); word++)
+    {
+        size_t begin = word * 64;
+        size_t end = std::min(size, begin + 64);
+        uint64_t bits = 0;
+        for (size_t i = begin; i < end; i++)
+        {
+            bits |= static_cast<uint64_t>(m_state[i]) << (i - begin);
+        }
+        m_mask[word] = bits;
+        count += static_cast<size_t>(__builtin_popcountll(bits));
+    }
+
+    m_anomalyCount = count;
+    return count;
+}
+
+bool BatchAnomalyDetection::isAnomaly(size_t index) const
+{
+    return (m_mask[index / 64] >> (index % 64)) & 1;
+}
+
+size_t BatchAnomalyDetection::getSize() const
+{
+    return m_size;
+}
+
+size_t BatchAnomalyDetection::getAnomalyCount() const
+{
+    return m_anomalyCount;
+}
+
+const std::vector<uint64_t> &BatchAnomalyDetection::getMask() const
+{
+    return m_mask;
+}
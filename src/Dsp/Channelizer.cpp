@@ -0,0 +1,198 @@
+#include <math.h>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Dsp/Channelizer.hpp"
+#include "Dsp/FftPlanCache.hpp"
+#include "Dsp/SpectralKernels.hpp"
+
+using namespace Dsp;
+
+Channelizer::Channelizer(size_t channelCount, size_t tapsPerChannel) : m_channelCount(channelCount),
+                                                                       m_taps(tapsPerChannel),
+                                                                       m_plan(nullptr),
+                                                                       m_batchPlan(nullptr)
+{
+    if (channelCount < 2 || tapsPerChannel == 0)
+    {
+        throw std::runtime_error("Invalid channelizer geometry");
+    }
+
+    // Windowed sinc cut off at fs / (2M), the channel edge.
+    const size_t length = m_channelCount * m_taps;
+    const double centre = (static_cast<double>(length) - 1.0) / 2.0;
+    std::vector<double> prototype(length);
+    double sum = 0.0;
+    for (size_t n = 0; n < length; n++)
+    {
+        double x = (static_cast<double>(n) - centre) / static_cast<double>(m_channelCount);
+        double sinc = fabs(x) < 1e-12 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+        double phase = 2.0 * M_PI * static_cast<double>(n) / (static_cast<double>(length) - 1.0);
+        double blackman = 0.42 - 0.5 * cos(phase) + 0.08 * cos(2.0 * phase);
+        prototype[n] = sinc * blackman;
+        sum += prototype[n];
+    }
+
+    m_coefficients.resize(length);
+    for (size_t p = 0; p < m_channelCount; p++)
+    {
+        for (size_t t = 0; t < m_taps; t++)
+        {
+            m_coefficients[p * m_taps + t] = static_cast<float>(prototype[p + t * m_channelCount] / sum);
+        }
+    }
+
+    FramePool &pool = FramePool::instance();
+    m_lines = pool.acquire<std::complex<float>>(2 * length);
+    m_pending = pool.acquire<std::complex<float>>(m_channelCount);
+    m_converted = pool.acquire<std::complex<float>>(BATCH_BLOCKS * m_channelCount);
+    m_branch = pool.acquire<std::complex<float>>(BATCH_BLOCKS * m_channelCount);
+    m_spectrum = pool.acquire<std::complex<float>>(BATCH_BLOCKS * m_channelCount);
+    m_plan = FftPlanCache::instance().get(m_channelCount, FFTW_BACKWARD, true);
+    m_batchPlan = FftPlanCache::instance().get(m_channelCount, FFTW_BACKWARD, true, BATCH_BLOCKS);
+
+    reset();
+}
+
+void Channelizer::reset()
+{
+    std::fill(m_lines.begin(), m_lines.end(), std::complex<float>(0.0f, 0.0f));
+    m_linePos = 0;
+    m_pendingCount = 0;
+}
+
+size_t Channelizer::getChannelCount() const
+{
+    return m_channelCount;
+}
+
+size_t Channelizer::outputCapacity(size_t count) const
+{
+    return (m_pendingCount + count) / m_channelCount;
+}
+
+double Channelizer::channelOffset(size_t channel, size_t channelCount, double sampleRate)
+{
+    double k = static_cast<double>(channel);
+    if (channel >= (channelCount + 1) / 2)
+    {
+        k -= static_cast<double>(channelCount);
+    }
+    return k * sampleRate / static_cast<double>(channelCount);
+}
+
+size_t Channelizer::process(const std::complex<float> *in, size_t count, std::complex<float> *out, size_t stride)
+{
+    size_t produced = 0;
+    size_t consumed = 0;
+
+    if (m_pendingCount > 0)
+    {
+        size_t n = std::min(m_channelCount - m_pendingCount, count);
+        std::copy(in, in + n, m_pending.data() + m_pendingCount);
+        m_pendingCount += n;
+        consumed = n;
+        if (m_pendingCount < m_channelCount)
+        {
+            return 0;
+        }
+        processBlock(m_pending.data(), out, stride);
+        m_pendingCount = 0;
+        produced = 1;
+    }
+
+    // Full batches share one FFT call; the remainder goes block by block.
+    while (count - consumed >= BATCH_BLOCKS * m_channelCount)
+    {
+        for (size_t b = 0; b < BATCH_BLOCKS; b++)
+        {
+            filterBlock(in + consumed + b * m_channelCount, m_branch.data() + b * m_channelCount);
+        }
+        fftwf_execute_dft(m_batchPlan,
+                          reinterpret_cast<fftwf_complex *>(m_branch.data()),
+                          reinterpret_cast<fftwf_complex *>(m_spectrum.data()));
+        for (size_t b = 0; b < BATCH_BLOCKS; b++)
+        {
+            scatter(m_spectrum.data() + b * m_channelCount, out + produced + b, stride);
+        }
+        consumed += BATCH_BLOCKS * m_channelCount;
+        produced += BATCH_BLOCKS;
+    }
+
+    while (count - consumed >= m_channelCount)
+    {
+        processBlock(in + consumed, out + produced, stride);
+        consumed += m_channelCount;
+        produced++;
+    }
+
+    std::copy(in + consumed, in + count, m_pending.data());
+    m_pendingCount = count - consumed;
+    return produced;
+}
+
+size_t Channelizer::process(const void *in, const SampleFormat &format, size_t count, std::complex<float> *out, size_t stride)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(in);
+    const size_t sampleBytes = format.bytesPerSample();
+    size_t produced = 0;
+    size_t consumed = 0;
+    while (consumed < count)
+    {
+        size_t n = std::min(BATCH_BLOCKS * m_channelCount, count - consumed);
+        SpectralKernels::convert(bytes + consumed * sampleBytes, format, m_converted.data(), n);
+        produced += process(m_converted.data(), n, out + produced, stride);
+        consumed += n;
+    }
+    return produced;
+}
+
+void Channelizer::processBlock(const std::complex<float> *block, std::complex<float> *out, size_t stride)
+{
+    filterBlock(block, m_branch.data());
+
+    // y_k = sum_p v_p e^{+j 2 pi p k / M}: the unnormalised inverse DFT.
+    fftwf_execute_dft(m_plan,
+                      reinterpret_cast<fftwf_complex *>(m_branch.data()),
+                      reinterpret_cast<fftwf_complex *>(m_spectrum.data()));
+    scatter(m_spectrum.data(), out, stride);
+}
+
+void Channelizer::filterBlock(const std::complex<float> *block, std::complex<float> *branch)
+{
+    // Advance every delay line by one and push the newest sample of branch
+    // p, x[n - p], at the head; the head is mirrored P samples later.
+    m_linePos = m_linePos == 0 ? m_taps - 1 : m_linePos - 1;
+    std::complex<float> *lines = m_lines.data();
+    const size_t lineStride = 2 * m_taps;
+    for (size_t p = 0; p < m_channelCount; p++)
+    {
+        std::complex<float> *line = lines + p * lineStride;
+        const std::complex<float> sample = block[m_channelCount - 1 - p];
+        line[m_linePos] = sample;
+        line[m_linePos + m_taps] = sample;
+    }
+
+    for (size_t p = 0; p < m_channelCount; p++)
+    {
+        const float *h = m_coefficients.data() + p * m_taps;
+        const float *x = reinterpret_cast<const float *>(lines + p * lineStride + m_linePos);
+        float re = 0.0f;
+        float im = 0.0f;
+        for (size_t t = 0; t < m_taps; t++)
+        {
+            re += h[t] * x[2 * t];
+            im += h[t] * x[2 * t + 1];
+        }
+        branch[p] = std::complex<float>(re, im);
+    }
+}
+
+void Channelizer::scatter(const std::complex<float> *spectrum, std::complex<float> *out, size_t stride) const
+{
+    for (size_t k = 0; k < m_channelCount; k++)
+    {
+        out[k * stride] = spectrum[k];
+    }
+}
@@ -0,0 +1,85 @@
+#include "Dsp/DistributionFitter.hpp"
+#include "Dsp/AnomalyDetection.hpp"
+
+using namespace Dsp;
+
+DistributionFitter::Target::Target() : m_slot(std::make_shared<Slot>()) {}
+
+DistributionFitter::Target::Target(const Target &) : m_slot(std::make_shared<Slot>()) {}
+
+DistributionFitter::Target &DistributionFitter::Target::operator=(const Target &)
+{
+    return *this;
+}
+
+std::unique_ptr<Model::CauchyParams> DistributionFitter::Target::take()
+{
+    return std::unique_ptr<Model::CauchyParams>(m_slot->pending.exchange(nullptr, std::memory_order_acquire));
+}
+
+DistributionFitter::Target::Slot::~Slot()
+{
+    delete pending.load();
+}
+
+DistributionFitter &DistributionFitter::instance()
+{
+    static DistributionFitter fitter;
+    return fitter;
+}
+
+DistributionFitter::DistributionFitter() : m_worker(&DistributionFitter::workerThread, this) {}
+
+DistributionFitter::~DistributionFitter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_one();
+    m_worker.join();
+}
+
+void DistributionFitter::submit(Target &target, std::vector<double> &&samples, double x0, double sigma, double lambda)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &job : m_jobs)
+        {
+            if (job.slot == target.m_slot)
+            {
+                job.samples = std::move(samples);
+                job.x0 = x0;
+                job.sigma = sigma;
+                job.lambda = lambda;
+                return;
+            }
+        }
+        m_jobs.push_back(Job{target.m_slot, std::move(samples), x0, sigma, lambda});
+    }
+    m_condition.notify_one();
+}
+
+void DistributionFitter::workerThread()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]
+                             { return m_stopping || m_jobs.empty() == false; });
+            if (m_stopping)
+            {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        double lambda = AnomalyDetection::mle(job.samples, job.x0, job.sigma, job.lambda);
+
+        Model::CauchyParams *params = new Model::CauchyParams{job.x0, job.sigma, lambda};
+        delete job.slot->pending.exchange(params, std::memory_order_acq_rel);
+    }
+}
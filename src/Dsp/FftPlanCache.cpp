@@ -0,0 +1,147 @@
+#include <string>
+#include <stdexcept>
+
+#include "Dsp/FftPlanCache.hpp"
+
+using namespace Dsp;
+
+FftPlanCache &FftPlanCache::instance()
+{
+    static FftPlanCache cache;
+    return cache;
+}
+
+// FFTW requires fftwf_init_threads() before any other FFTW call, wisdom
+// import included, and the cache is the first user of FFTW.
+FftPlanCache::FftPlanCache()
+{
+#if defined(DSP_HAVE_FFTW_THREADS)
+    if (fftwf_init_threads() == 0)
+    {
+        throw std::runtime_error("Failed to initialise FFTW threads");
+    }
+    m_threadsInitialised = true;
+#endif
+}
+
+FftPlanCache::~FftPlanCache()
+{
+    for (auto &entry : m_plans)
+    {
+        fftwf_destroy_plan(entry.second);
+    }
+#if defined(DSP_HAVE_FFTW_THREADS)
+    if (m_threadsInitialised == true)
+    {
+        fftwf_cleanup_threads();
+    }
+#endif
+}
+
+bool FftPlanCache::threadsSupported()
+{
+#if defined(DSP_HAVE_FFTW_THREADS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+fftwf_plan FftPlanCache::get(size_t size, int direction, bool aligned, size_t batch, bool inPlace, size_t threads)
+{
+    if (size == 0 || batch == 0 || threads == 0)
+    {
+        throw std::runtime_error("Invalid FFTW plan geometry");
+    }
+    if (threadsSupported() == false)
+    {
+        threads = 1;
+    }
+    Key key{size, direction, aligned, batch, inPlace, threads};
+
+    // The FFTW planner is not thread-safe; plan execution is.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_plans.find(key);
+    if (it != m_plans.end())
+    {
+        return it->second;
+    }
+
+#if defined(DSP_HAVE_FFTW_THREADS)
+    // The thread count is planner state, so set it for every plan.
+    fftwf_plan_with_nthreads(static_cast<int>(threads));
+#endif
+
+    // FFTW_MEASURE and above scribble over the arrays, so plan on scratch.
+    const size_t total = size * batch;
+    fftwf_complex *in = static_cast<fftwf_complex *>(fftwf_malloc(sizeof(fftwf_complex) * total));
+    fftwf_complex *out = inPlace ? in : static_cast<fftwf_complex *>(fftwf_malloc(sizeof(fftwf_complex) * total));
+    if (in == nullptr || out == nullptr)
+    {
+        fftwf_free(in);
+        if (inPlace == false)
+        {
+            fftwf_free(out);
+        }
+        throw std::runtime_error("Failed to allocate FFTW planning buffers");
+    }
+
+    unsigned flags = m_plannerFlags | (aligned ? 0 : FFTW_UNALIGNED);
+    fftwf_plan plan;
+    if (batch == 1 && inPlace == false)
+    {
+        plan = fftwf_plan_dft_1d(static_cast<int>(size), in, out, direction, flags);
+    }
+    else
+    {
+        int n = static_cast<int>(size);
+        plan = fftwf_plan_many_dft(1, &n, static_cast<int>(batch),
+                                   in, nullptr, 1, n,
+                                   out, nullptr, 1, n,
+                                   direction, flags);
+    }
+
+    fftwf_free(in);
+    if (inPlace == false)
+    {
+        fftwf_free(out);
+    }
+
+    if (plan == nullptr)
+    {
+        throw std::runtime_error("Failed to create FFTW plan");
+    }
+
+    m_plans.emplace(key, plan);
+    return plan;
+}
+
+void FftPlanCache::setPlannerFlags(unsigned flags)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_plannerFlags = flags;
+}
+
+unsigned FftPlanCache::getPlannerFlags()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_plannerFlags;
+}
+
+bool FftPlanCache::loadWisdom(const std::string &fileName)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return fftwf_import_wisdom_from_filename(fileName.c_str()) != 0;
+}
+
+bool FftPlanCache::saveWisdom(const std::string &fileName)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return fftwf_export_wisdom_to_filename(fileName.c_str()) != 0;
+}
+
+size_t FftPlanCache::size()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_plans.size();
+}
@@ -0,0 +1,85 @@
+#include <cstdlib>
+#include <stdexcept>
+
+#include "Dsp/FramePool.hpp"
+
+using namespace Dsp;
+
+FramePool &FramePool::instance()
+{
+    // Never destroyed: frames owned by other statics may be released during
+    // exit, after a function-local pool would already be gone.
+    static FramePool *pool = new FramePool();
+    return *pool;
+}
+
+size_t FramePool::roundUp(size_t bytes)
+{
+    bytes = bytes == 0 ? ALIGNMENT : bytes;
+    return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+void FramePool::reserve(size_t bytes, size_t count)
+{
+    bytes = roundUp(bytes);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<void *> &list = m_free[bytes];
+    list.reserve(list.size() + count);
+    for (size_t i = 0; i < count; i++)
+    {
+        void *data = std::aligned_alloc(ALIGNMENT, bytes);
+        if (data == nullptr)
+        {
+            throw std::runtime_error("Failed to allocate frame");
+        }
+        ++m_allocationCount;
+        list.push_back(data);
+    }
+}
+
+size_t FramePool::getAllocationCount()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_allocationCount;
+}
+
+size_t FramePool::getFreeCount()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (auto &entry : m_free)
+    {
+        count += entry.second.size();
+    }
+    return count;
+}
+
+void *FramePool::take(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<void *> &list = m_free[bytes];
+    if (list.empty() == false)
+    {
+        void *data = list.back();
+        list.pop_back();
+        return data;
+    }
+
+    void *data = std::aligned_alloc(ALIGNMENT, bytes);
+    if (data == nullptr)
+    {
+        throw std::runtime_error("Failed to allocate frame");
+    }
+    ++m_allocationCount;
+
+    // Make room now so handing the frame back never reallocates.
+    list.reserve(m_allocationCount);
+    return data;
+}
+
+void FramePool::give(void *data, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free[bytes].push_back(data);
+}
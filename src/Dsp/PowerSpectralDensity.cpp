@@ -1,18 +1,61 @@
 #include <math.h>
+#include <map>
+#include <mutex>
 #include <fstream>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
 
 #include "Dsp/PowerSpectralDensity.hpp"
+#include "Dsp/SpectralKernels.hpp"
+#include "Dsp/FftPlanCache.hpp"
+#include "Dsp/WorkerPool.hpp"
 
 using namespace Dsp;
 
 static_assert(sizeof(std::complex<float>) == sizeof(fftwf_complex),
               "std::complex<float> must have same layout as fftwf_complex");
 
-PowerSpectralDensity::PowerSpectralDensity() {}
+PowerSpectralDensity::PowerSpectralDensity() : m_alignedPlan(nullptr),
+                                               m_unalignedPlan(nullptr),
+                                               m_fftSize(0) {}
 
-PowerSpectralDensity::~PowerSpectralDensity()
+PowerSpectralDensity::~PowerSpectralDensity() {}
+
+PowerSpectralDensity::PowerSpectralDensity(const PowerSpectralDensity &other) : m_alignedPlan(nullptr),
+                                                                                m_unalignedPlan(nullptr),
+                                                                                m_fftSize(0)
+{
+    *this = other;
+}
+
+PowerSpectralDensity &PowerSpectralDensity::operator=(const PowerSpectralDensity &other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    m_alignedPlan = other.m_alignedPlan;
+    m_unalignedPlan = other.m_unalignedPlan;
+    m_batchPlans = other.m_batchPlans;
+    m_nextBatchPlan = other.m_nextBatchPlan;
+    m_fftSize = other.m_fftSize;
+    m_window = other.m_window;
+    m_welchAverageCount = other.m_welchAverageCount;
+    m_welchOverlap = other.m_welchOverlap;
+    m_threads = other.m_threads;
+    m_workers.reset(other.m_workers ? new WorkerPool(other.m_threads) : nullptr);
+    resetWelch();
+    return *this;
+}
+
+// A plan may only be executed on arrays with the alignment it was created
+// for, so buffers that are not SIMD-aligned use an FFTW_UNALIGNED plan.
+static bool isAligned(const std::complex<float> *in, const std::complex<float> *out)
 {
-    fftwf_destroy_plan(m_plan);
+    return fftwf_alignment_of(const_cast<float *>(reinterpret_cast<const float *>(in))) == 0 &&
+           fftwf_alignment_of(const_cast<float *>(reinterpret_cast<const float *>(out))) == 0;
 }
 
 size_t PowerSpectralDensity::getFftSize() const
@@ -22,53 +65,358 @@ size_t PowerSpectralDensity::getFftSize() const
 
 void PowerSpectralDensity::execute(std::complex<float> *in, std::complex<float> *out)
 {
-    hanningWindow(in);
-    fftwf_execute_dft(m_plan,
+    SpectralKernels::applyWindow(in, m_window->data(), m_fftSize);
+    fftwf_execute_dft(plan(in, out),
                       reinterpret_cast<fftwf_complex *>(in),
                       reinterpret_cast<fftwf_complex *>(out));
 }
 
-void PowerSpectralDensity::hanningWindow(std::complex<float> *in)
+void PowerSpectralDensity::execute(const void *samples, const SampleFormat &format, std::complex<float> *out)
+{
+    std::complex<float> *work = m_work.data();
+    SpectralKernels::convertWindow(samples, format, m_window->data(), work, m_fftSize);
+    fftwf_execute_dft(plan(work, out),
+                      reinterpret_cast<fftwf_complex *>(work),
+                      reinterpret_cast<fftwf_complex *>(out));
+}
+
+void PowerSpectralDensity::executeBatch(const void *samples, const SampleFormat &format, size_t frames, std::complex<float> *out)
+{
+    if (m_workers && frames > 1)
+    {
+        executeSplit(samples, &format, frames, out);
+        return;
+    }
+
+    // Convert and window straight into out, then transform it in place.
+    const uint8_t *bytes = static_cast<const uint8_t *>(samples);
+    const size_t frameBytes = m_fftSize * format.bytesPerSample();
+    for (size_t f = 0; f < frames; f++)
+    {
+        SpectralKernels::convertWindow(bytes + f * frameBytes, format, m_window->data(), out + f * m_fftSize, m_fftSize);
+    }
+    fftwf_execute_dft(batchPlan(out, out, frames),
+                      reinterpret_cast<fftwf_complex *>(out),
+                      reinterpret_cast<fftwf_complex *>(out));
+}
+
+void PowerSpectralDensity::executeBatch(std::complex<float> *inOut, size_t frames)
 {
-    for (size_t i = 0; i < m_fftSize; i++)
+    if (m_workers && frames > 1)
     {
-        float window = sinf((M_PI * i) / m_fftSize);
-        in[i] *= (window * window);
+        executeSplit(nullptr, nullptr, frames, inOut);
+        return;
     }
+
+    for (size_t f = 0; f < frames; f++)
+    {
+        SpectralKernels::applyWindow(inOut + f * m_fftSize, m_window->data(), m_fftSize);
+    }
+    fftwf_execute_dft(batchPlan(inOut, inOut, frames),
+                      reinterpret_cast<fftwf_complex *>(inOut),
+                      reinterpret_cast<fftwf_complex *>(inOut));
 }
 
-void PowerSpectralDensity::computeRealPsd(const std::complex<float> *fft, float *real, float sampleRate)
+// Each worker converts (or just windows, without a format) and transforms
+// its own run of frames in place, so spectrum f still lands at out[f * N].
+// Runs are planned through the shared cache rather than m_batchPlans, which
+// the workers would race on.
+void PowerSpectralDensity::executeSplit(const void *samples, const SampleFormat *format, size_t frames, std::complex<float> *out)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(samples);
+    const size_t frameBytes = format != nullptr ? m_fftSize * format->bytesPerSample() : 0;
+    const float *window = m_window->data();
+
+    auto task = [&](size_t begin, size_t end)
+    {
+        std::complex<float> *run = out + begin * m_fftSize;
+        for (size_t f = begin; f < end; f++)
+        {
+            std::complex<float> *frame = out + f * m_fftSize;
+            if (format != nullptr)
+            {
+                SpectralKernels::convertWindow(bytes + f * frameBytes, *format, window, frame, m_fftSize);
+            }
+            else
+            {
+                SpectralKernels::applyWindow(frame, window, m_fftSize);
+            }
+        }
+        fftwf_plan plan = FftPlanCache::instance().get(m_fftSize, FFTW_FORWARD, isAligned(run, run), end - begin, true);
+        fftwf_execute_dft(plan,
+                          reinterpret_cast<fftwf_complex *>(run),
+                          reinterpret_cast<fftwf_complex *>(run));
+    };
+    m_workers->run(frames, task);
+}
+
+void PowerSpectralDensity::executeBatchPower(const void *samples, const SampleFormat &format, size_t frames, float *power)
+{
+    if (m_batchWork.size() < frames * m_fftSize)
+    {
+        m_batchWork.reset();
+        m_batchWork = FramePool::instance().acquire<std::complex<float>>(frames * m_fftSize);
+    }
+    executeBatch(samples, format, frames, m_batchWork.data());
+    accumulatePower(m_batchWork.data(), frames, power);
+}
+
+void PowerSpectralDensity::prepareBatch(size_t frames)
+{
+    if (m_fftSize == 0 || frames == 0)
+    {
+        return;
+    }
+
+    FftPlanCache &cache = FftPlanCache::instance();
+    if (m_workers && frames > 1)
+    {
+        // The run lengths executeSplit() hands the pool's threads.
+        const size_t threads = m_workers->getThreadCount();
+        const size_t base = frames / threads;
+        if (frames % threads != 0)
+        {
+            cache.get(m_fftSize, FFTW_FORWARD, true, base + 1, true);
+        }
+        if (base > 0)
+        {
+            cache.get(m_fftSize, FFTW_FORWARD, true, base, true);
+        }
+        return;
+    }
+    cache.get(m_fftSize, FFTW_FORWARD, true, frames, true, m_threads);
+}
+
+void PowerSpectralDensity::accumulatePower(const std::complex<float> *spectra, size_t frames, float *power) const
+{
+    for (size_t f = 0; f < frames; f++)
+    {
+        const std::complex<float> *spectrum = spectra + f * m_fftSize;
+        for (size_t i = 0; i < m_fftSize; i++)
+        {
+            power[i] += std::norm(spectrum[i]);
+        }
+    }
+}
+
+fftwf_plan PowerSpectralDensity::batchPlan(const std::complex<float> *in, const std::complex<float> *out, size_t frames)
+{
+    bool inPlace = in == out;
+    if (frames == 1 && inPlace == false)
+    {
+        return plan(in, out);
+    }
+
+    bool aligned = isAligned(in, out);
+    for (auto &cached : m_batchPlans)
+    {
+        if (cached.plan != nullptr && cached.frames == frames &&
+            cached.aligned == aligned && cached.inPlace == inPlace)
+        {
+            return cached.plan;
+        }
+    }
+
+    BatchPlan &cached = m_batchPlans[m_nextBatchPlan];
+    m_nextBatchPlan = (m_nextBatchPlan + 1) % BATCH_PLAN_SLOTS;
+    cached.plan = FftPlanCache::instance().get(m_fftSize, FFTW_FORWARD, aligned, frames, inPlace, m_threads);
+    cached.frames = frames;
+    cached.aligned = aligned;
+    cached.inPlace = inPlace;
+    return cached.plan;
+}
+
+fftwf_plan PowerSpectralDensity::plan(const std::complex<float> *in, const std::complex<float> *out)
+{
+    bool aligned = isAligned(in, out);
+
+    fftwf_plan &cached = aligned ? m_alignedPlan : m_unalignedPlan;
+    if (cached == nullptr)
+    {
+        cached = FftPlanCache::instance().get(m_fftSize, FFTW_FORWARD, aligned, 1, false, m_threads);
+    }
+    return cached;
+}
+
+std::shared_ptr<const std::vector<float>> PowerSpectralDensity::hanningWindow(size_t size)
 {
-    for (size_t i = 0; i < m_fftSize; i++)
+    // Windows are shared by every instance with the same FFT size.
+    static std::mutex mutex;
+    static std::map<size_t, std::shared_ptr<const std::vector<float>>> cache;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(size);
+    if (it != cache.end())
     {
-        real[i] = std::abs(fft[i]);
-        real[i] = real[i] * real[i];
-        real[i] = real[i] / (static_cast<float>(m_fftSize) * sampleRate);
-        real[i] = 10.0f * log10f(real[i]);
+        return it->second;
     }
 
-    rotate(real, m_fftSize);
+    auto window = std::make_shared<std::vector<float>>(size);
+    for (size_t i = 0; i < size; i++)
+    {
+        double w = sin((M_PI * i) / size);
+        (*window)[i] = static_cast<float>(w * w);
+    }
+    cache.emplace(size, window);
+    return window;
+}
+
+void PowerSpectralDensity::computeRealPsd(const std::complex<float> *fft, float *real, float sampleRate)
+{
+    SpectralKernels::powerDb(fft, real, m_fftSize, 1.0f / (static_cast<float>(m_fftSize) * sampleRate));
 }
 
 void PowerSpectralDensity::setFftSize(double bandwidthHz)
 {
     double bandwidthMhz = bandwidthHz / 1e6;
     size_t size = pow(2, 6 + floor(log2(bandwidthMhz)));
+    if (size == m_fftSize)
+    {
+        return;
+    }
+
     m_fftSize = size;
+    m_window = hanningWindow(m_fftSize);
+
+    m_alignedPlan = FftPlanCache::instance().get(m_fftSize, FFTW_FORWARD, true, 1, false, m_threads);
+    m_unalignedPlan = nullptr;
+    m_batchPlans.fill(BatchPlan());
+    m_batchWork.reset();
+
+    resetWelch();
+}
+
+void PowerSpectralDensity::setThreadCount(size_t threads)
+{
+    threads = std::max<size_t>(1, threads);
+    if (threads == m_threads)
+    {
+        return;
+    }
+
+    m_threads = threads;
+    m_workers.reset();
+    if (m_threads > 1 && FftPlanCache::threadsSupported() == false)
+    {
+        m_workers = std::make_unique<WorkerPool>(m_threads);
+    }
+
+    // Cached plans were made for the old thread count.
+    m_alignedPlan = nullptr;
+    m_unalignedPlan = nullptr;
+    m_batchPlans.fill(BatchPlan());
+    if (m_fftSize > 0)
+    {
+        m_alignedPlan = FftPlanCache::instance().get(m_fftSize, FFTW_FORWARD, true, 1, false, m_threads);
+    }
+    prepareBatch(m_welchAverageCount);
+}
 
-    m_plan = fftwf_plan_dft_1d(m_fftSize, NULL, NULL, FFTW_FORWARD, FFTW_ESTIMATE);
+size_t PowerSpectralDensity::getThreadCount() const
+{
+    return m_threads;
+}
+
+void PowerSpectralDensity::setWelch(size_t averageCount, float overlap)
+{
+    if (averageCount == 0 || overlap < 0.0f || overlap >= 1.0f)
+    {
+        throw std::runtime_error("Invalid Welch configuration");
+    }
+
+    m_welchAverageCount = averageCount;
+    m_welchOverlap = overlap;
+    resetWelch();
+}
+
+size_t PowerSpectralDensity::welch(const std::complex<float> *samples, size_t count, float *real, float sampleRate)
+{
+    return welch(samples, SampleFormat(), count, real, sampleRate);
+}
+
+size_t PowerSpectralDensity::welch(const void *samples, const SampleFormat &format, size_t count, float *real, float sampleRate)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(samples);
+    const size_t sampleBytes = format.bytesPerSample();
+    size_t emitted = 0;
+    size_t consumed = 0;
+    while (consumed < count)
+    {
+        size_t n = std::min(m_fftSize - m_welchFill, count - consumed);
+        SpectralKernels::convert(bytes + consumed * sampleBytes, format, m_welchSegment.data() + m_welchFill, n);
+        m_welchFill += n;
+        consumed += n;
+
+        if (m_welchFill < m_fftSize)
+        {
+            break;
+        }
+
+        // Segments overlap, so queue a copy for the batch and keep the
+        // overlapping tail of the segment for the next one.
+        std::copy(m_welchSegment.begin(), m_welchSegment.end(), m_welchBatch.data() + m_welchFrames * m_fftSize);
+        std::copy(m_welchSegment.data() + m_welchHop, m_welchSegment.end(), m_welchSegment.begin());
+        m_welchFill = m_fftSize - m_welchHop;
+
+        if (++m_welchFrames == m_welchAverageCount)
+        {
+            executeBatch(m_welchBatch.data(), m_welchAverageCount);
+            accumulatePower(m_welchBatch.data(), m_welchAverageCount, m_welchAccum.data());
+
+            float scale = 1.0f / (static_cast<float>(m_welchAverageCount) * static_cast<float>(m_fftSize) * sampleRate);
+            SpectralKernels::toDb(m_welchAccum.data(), real, m_fftSize, scale);
+            std::fill(m_welchAccum.begin(), m_welchAccum.end(), 0.0f);
+
+            m_welchFrames = 0;
+            ++emitted;
+        }
+    }
+
+    return emitted;
+}
+
+void PowerSpectralDensity::resetWelch()
+{
+    m_welchHop = std::max<size_t>(1, static_cast<size_t>(lroundf(m_fftSize * (1.0f - m_welchOverlap))));
+    m_welchHop = std::min(m_welchHop, m_fftSize);
+    m_welchFill = 0;
+    m_welchFrames = 0;
+
+    // Release first so a same-size reset reuses these very buffers.
+    m_welchSegment.reset();
+    m_welchBatch.reset();
+    m_work.reset();
+    m_welchAccum.reset();
+
+    FramePool &pool = FramePool::instance();
+    m_welchSegment = pool.acquire<std::complex<float>>(m_fftSize);
+    m_welchBatch = pool.acquire<std::complex<float>>(m_welchAverageCount * m_fftSize);
+    m_work = pool.acquire<std::complex<float>>(m_fftSize);
+    m_welchAccum = pool.acquire<float>(m_fftSize);
+    std::fill(m_welchSegment.begin(), m_welchSegment.end(), std::complex<float>(0.0f, 0.0f));
+    std::fill(m_welchAccum.begin(), m_welchAccum.end(), 0.0f);
+    prepareBatch(m_welchAverageCount);
 }
 
 double PowerSpectralDensity::computeAvgPower(const std::complex<float> *iqSamples)
 {
+    return computeAvgPower(iqSamples, m_fftSize);
+}
+
+double PowerSpectralDensity::computeAvgPower(const std::complex<float> *iqSamples, size_t count)
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
     double magnitudeSquared = 0.0f;
-    for (size_t i = 0; i < m_fftSize; i++)
+    for (size_t i = 0; i < count; i++)
     {
-        double magnitude = std::abs(iqSamples[i]);
-        magnitudeSquared += magnitude * magnitude;
+        magnitudeSquared += std::norm(iqSamples[i]);
     }
 
-    return magnitudeSquared / static_cast<double>(m_fftSize);
+    return magnitudeSquared / static_cast<double>(count);
 }
 
 void PowerSpectralDensity::toFile(const char *fileName, double cf, double bw, float *arr, size_t size)
@@ -97,19 +445,3 @@ void PowerSpectralDensity::toFile(const char *fileName, double cf, double bw, fl
         std::rename(temp_file.c_str(), fileName);
     }
 }
-
-void PowerSpectralDensity::rotate(float *arr, size_t size)
-{
-    size_t mid = size / 2;
-    for (size_t i = 0; i < mid; i++)
-    {
-        swap(arr[i], arr[mid + i]);
-    }
-}
-
-void PowerSpectralDensity::swap(float &a, float &b)
-{
-    float c = b;
-    b = a;
-    a = c;
-}
\ No newline at end of file
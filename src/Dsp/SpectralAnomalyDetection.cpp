@@ -0,0 +1,149 @@
+#include <algorithm>
+
+#include "Dsp/SpectralAnomalyDetection.hpp"
+
+using namespace Dsp;
+
+namespace
+{
+    // Kept out of line with restrict-qualified arguments so the compiler
+    // can prove the SoA arrays do not alias and vectorise the loop.
+    void updateBins(const float *__restrict in,
+                    float *__restrict mean,
+                    float *__restrict variance,
+                    int32_t *__restrict high,
+                    int32_t *__restrict low,
+                    int32_t *__restrict state,
+                    size_t size,
+                    int32_t armed,
+                    float rate,
+                    float k2,
+                    float minExcess,
+                    int32_t consecutive)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            float x = in[i];
+            float d = x - mean[i];
+            // All ones when the bin is hot, zero otherwise.
+            int32_t hot = armed & -static_cast<int32_t>((d > minExcess) & (d * d > k2 * variance[i]));
+
+            int32_t h = (high[i] + 1) & hot;
+            int32_t l = (low[i] + 1) & ~hot;
+            h = h < consecutive ? h : consecutive;
+            l = l < consecutive ? l : consecutive;
+            high[i] = h;
+            low[i] = l;
+            state[i] = (h >= consecutive) | ((l < consecutive) & state[i]);
+
+            // Exponentially weighted mean/variance (West's update), frozen
+            // while the bin is hot.
+            float step = rate * static_cast<float>(1 + hot);
+            float m = mean[i] + step * d;
+            mean[i] = m;
+            variance[i] += step * (d * (x - m) - variance[i]);
+        }
+    }
+}
+
+void SpectralAnomalyDetection::reset(size_t size)
+{
+    m_size = size;
+    m_frames = 0;
+    m_anomalyCount = 0;
+    m_changed = false;
+    m_mean.assign(size, 0.0f);
+    m_variance.assign(size, 0.0f);
+    m_high.assign(size, 0);
+    m_low.assign(size, 0);
+    m_state.assign(size, 0);
+    m_mask.assign((size + 63) / 64, 0);
+}
+
+size_t SpectralAnomalyDetection::process(const float *psdDb, size_t size)
+{
+    if (size != m_size)
+    {
+        reset(size);
+    }
+
+    // Cumulative average while warming up, then a fixed smoothing factor.
+    const float rate = std::max(SMOOTHING, 1.0f / static_cast<float>(m_frames + 1));
+    const int32_t armed = m_frames >= WARMUP_FRAMES ? -1 : 0;
+    const float k2 = THRESHOLD_SIGMA * THRESHOLD_SIGMA;
+
+    updateBins(psdDb, m_mean.data(), m_variance.data(), m_high.data(), m_low.data(), m_state.data(),
+               size, armed, rate, k2, MIN_EXCESS_DB, CONSECUTIVE_COUNT);
+
+    size_t count = 0;
+    bool changed = false;
+    for (size_t word = 0; word < m_mask.size(); word++)
+    {
+        size_t begin = word * 64;
+        size_t end = std::min(size, begin + 64);
+        uint64_t bits = 0;
+        for (size_t i = begin; i < end; i++)
+        {
+            bits |= static_cast<uint64_t>(m_state[i]) << (i - begin);
+        }
+        changed |= bits != m_mask[word];
+        m_mask[word] = bits;
+        count += static_cast<size_t>(__builtin_popcountll(bits));
+    }
+
+    m_frames++;
+    m_anomalyCount = count;
+    m_changed = changed;
+    return count;
+}
+
+bool SpectralAnomalyDetection::isReady() const
+{
+    return m_frames > WARMUP_FRAMES;
+}
+
+bool SpectralAnomalyDetection::hasChanged() const
+{
+    return m_changed;
+}
+
+size_t SpectralAnomalyDetection::getSize() const
+{
+    return m_size;
+}
+
+size_t SpectralAnomalyDetection::getAnomalyCount() const
+{
+    return m_anomalyCount;
+}
+
+const std::vector<uint64_t> &SpectralAnomalyDetection::getMask() const
+{
+    return m_mask;
+}
+
+std::vector<std::pair<size_t, size_t>> SpectralAnomalyDetection::getRanges() const
+{
+    std::vector<std::pair<size_t, size_t>> ranges;
+    bool inRange = false;
+    size_t first = 0;
+    for (size_t i = 0; i < m_size; i++)
+    {
+        bool set = (m_mask[i / 64] >> (i % 64)) & 1;
+        if (set && inRange == false)
+        {
+            first = i;
+            inRange = true;
+        }
+        else if (set == false && inRange)
+        {
+            ranges.emplace_back(first, i - 1);
+            inRange = false;
+        }
+    }
+    if (inRange)
+    {
+        ranges.emplace_back(first, m_size - 1);
+    }
+    return ranges;
+}
@@ -0,0 +1,581 @@
+#include <math.h>
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DSP_KERNELS_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define DSP_KERNELS_NEON 1
+#endif
+
+#include "Dsp/SpectralKernels.hpp"
+
+using namespace Dsp;
+
+namespace
+{
+    // 10 * log10(2)
+    const float DB_PER_OCTAVE = 3.01029995663981f;
+    const float TWO_OVER_LN2 = 2.88539008177793f;
+
+    typedef void (*ComplexKernel)(const std::complex<float> *, float *, size_t, float);
+    typedef void (*RealKernel)(const float *, float *, size_t, float);
+    typedef void (*ConvertKernel)(const void *, float, const float *, std::complex<float> *, size_t);
+    typedef void (*TailKernel)(const float *, const float *, const float *, const float *, float *, size_t);
+
+    const size_t FORMAT_COUNT = 4;
+    const float CU8_OFFSET = 127.5f;
+
+    // As in AnomalyDetection::sgn(), residuals below SIGN_EPSILON count as
+    // negative and exactly SIGN_EPSILON as zero.
+    const float SIGN_EPSILON = 1e-18f;
+    const float HALF_PI = 1.57079632679490f;
+    const float INV_PI = 0.318309886183791f;
+
+    // Odd minimax polynomial for atan on [0, 1], |error| < 2e-6 rad.
+    const float ATAN_C1 = 0.99997726f;
+    const float ATAN_C3 = -0.33262347f;
+    const float ATAN_C5 = 0.19354346f;
+    const float ATAN_C7 = -0.11643287f;
+    const float ATAN_C9 = 0.05265332f;
+    const float ATAN_C11 = -0.01172120f;
+
+    // log2(x) = e + log2(m), m in [1, 2). With t = (m - 1) / (m + 1),
+    // log2(m) = 2/ln2 * (t + t^3/3 + t^5/5 + t^7/7 + ...), t in [0, 1/3].
+    inline float fastDb(float x)
+    {
+        x = x < FLT_MIN ? FLT_MIN : x;
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        float e = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+        bits = (bits & 0x007FFFFFu) | 0x3F800000u;
+        float m;
+        std::memcpy(&m, &bits, sizeof(m));
+        float t = (m - 1.0f) / (m + 1.0f);
+        float t2 = t * t;
+        float poly = t * (1.0f + t2 * (1.0f / 3.0f + t2 * (1.0f / 5.0f + t2 * (1.0f / 7.0f))));
+        return DB_PER_OCTAVE * (e + TWO_OVER_LN2 * poly);
+    }
+
+    void powerDbRangeScalar(const std::complex<float> *fft, float *real, size_t size, float scale)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            float power = std::norm(fft[i]) * scale;
+            real[i] = 10.0f * log10f(power < FLT_MIN ? FLT_MIN : power);
+        }
+    }
+
+    void powerDbRangeFast(const std::complex<float> *fft, float *real, size_t size, float scale)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            real[i] = fastDb(std::norm(fft[i]) * scale);
+        }
+    }
+
+    void toDbRangeScalar(const float *power, float *real, size_t size, float scale)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            float p = power[i] * scale;
+            real[i] = 10.0f * log10f(p < FLT_MIN ? FLT_MIN : p);
+        }
+    }
+
+    void toDbRangeFast(const float *power, float *real, size_t size, float scale)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            real[i] = fastDb(power[i] * scale);
+        }
+    }
+
+    // atan(z) = pi/2 - atan(1/z) folds |z| > 1 onto the polynomial's range.
+    inline float fastAtan(float z)
+    {
+        float a = fabsf(z);
+        bool folded = a > 1.0f;
+        float t = folded ? 1.0f / a : a;
+        float t2 = t * t;
+        float poly = t * (ATAN_C1 + t2 * (ATAN_C3 + t2 * (ATAN_C5 + t2 * (ATAN_C7 + t2 * (ATAN_C9 + t2 * ATAN_C11)))));
+        return copysignf(folded ? HALF_PI - poly : poly, z);
+    }
+
+    // 1 - F(x) for the asymmetric Cauchy F of AnomalyDetection::cdf():
+    // (1 + lambda) / 2 - k / pi * atan(r / (sigma * k)), k = 1 + sgn(r) * lambda.
+    template <bool Fast>
+    void cauchyTailRange(const float *x, const float *x0, const float *sigma, const float *lambda, float *p, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            float r = x[i] - x0[i];
+            float sign = static_cast<float>((r > SIGN_EPSILON) - (r < SIGN_EPSILON));
+            float k = 1.0f + sign * lambda[i];
+            float z = r / (sigma[i] * k);
+            float angle = Fast ? fastAtan(z) : atanf(z);
+            p[i] = 0.5f * (1.0f + lambda[i]) - k * INV_PI * angle;
+        }
+    }
+
+    template <SampleFormat::Type Format>
+    inline float loadComponent(const void *in, size_t i)
+    {
+        if constexpr (Format == SampleFormat::Type::CS16)
+        {
+            return static_cast<float>(static_cast<const int16_t *>(in)[i]);
+        }
+        else if constexpr (Format == SampleFormat::Type::CS8)
+        {
+            return static_cast<float>(static_cast<const int8_t *>(in)[i]);
+        }
+        else if constexpr (Format == SampleFormat::Type::CU8)
+        {
+            return static_cast<float>(static_cast<const uint8_t *>(in)[i]) - CU8_OFFSET;
+        }
+        else
+        {
+            return static_cast<const float *>(in)[i];
+        }
+    }
+
+    template <SampleFormat::Type Format, bool Windowed>
+    void convertRangeScalar(const void *in, float scale, const float *window, std::complex<float> *out, size_t size)
+    {
+        float *iq = reinterpret_cast<float *>(out);
+        for (size_t i = 0; i < size; i++)
+        {
+            float gain = Windowed ? window[i] * scale : scale;
+            float re = loadComponent<Format>(in, 2 * i);
+            float im = loadComponent<Format>(in, 2 * i + 1);
+            iq[2 * i] = re * gain;
+            iq[2 * i + 1] = im * gain;
+        }
+    }
+
+    // Kernel tables are indexed by SampleFormat::Type.
+    template <bool Windowed>
+    void scalarConvertKernels(ConvertKernel *kernels)
+    {
+        kernels[static_cast<size_t>(SampleFormat::Type::CF32)] = convertRangeScalar<SampleFormat::Type::CF32, Windowed>;
+        kernels[static_cast<size_t>(SampleFormat::Type::CS16)] = convertRangeScalar<SampleFormat::Type::CS16, Windowed>;
+        kernels[static_cast<size_t>(SampleFormat::Type::CS8)] = convertRangeScalar<SampleFormat::Type::CS8, Windowed>;
+        kernels[static_cast<size_t>(SampleFormat::Type::CU8)] = convertRangeScalar<SampleFormat::Type::CU8, Windowed>;
+    }
+
+    inline const void *advance(const void *in, SampleFormat::Type format, size_t samples)
+    {
+        SampleFormat f;
+        f.type = format;
+        return static_cast<const uint8_t *>(in) + samples * f.bytesPerSample();
+    }
+
+#if defined(DSP_KERNELS_X86)
+    __attribute__((target("avx2,fma"))) inline __m256 fastDbAvx2(__m256 x)
+    {
+        x = _mm256_max_ps(x, _mm256_set1_ps(FLT_MIN));
+        __m256i bits = _mm256_castps_si256(x);
+        __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+        __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                                       _mm256_set1_epi32(0x3F800000)));
+        const __m256 one = _mm256_set1_ps(1.0f);
+        __m256 t = _mm256_div_ps(_mm256_sub_ps(m, one), _mm256_add_ps(m, one));
+        __m256 t2 = _mm256_mul_ps(t, t);
+        __m256 poly = _mm256_fmadd_ps(t2, _mm256_set1_ps(1.0f / 7.0f), _mm256_set1_ps(1.0f / 5.0f));
+        poly = _mm256_fmadd_ps(t2, poly, _mm256_set1_ps(1.0f / 3.0f));
+        poly = _mm256_fmadd_ps(t2, poly, one);
+        poly = _mm256_mul_ps(t, poly);
+        __m256 log2x = _mm256_fmadd_ps(_mm256_set1_ps(TWO_OVER_LN2), poly, e);
+        return _mm256_mul_ps(_mm256_set1_ps(DB_PER_OCTAVE), log2x);
+    }
+
+    __attribute__((target("avx2,fma"))) void powerDbRangeAvx2(const std::complex<float> *fft, float *real, size_t size, float scale)
+    {
+        const float *in = reinterpret_cast<const float *>(fft);
+        const __m256 vscale = _mm256_set1_ps(scale);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            __m256 a = _mm256_loadu_ps(in + 2 * i);
+            __m256 b = _mm256_loadu_ps(in + 2 * i + 8);
+            // hadd interleaves 128-bit lanes: p0 p1 p4 p5 | p2 p3 p6 p7
+            __m256 p = _mm256_hadd_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b));
+            p = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(p), 0xD8));
+            _mm256_storeu_ps(real + i, fastDbAvx2(_mm256_mul_ps(p, vscale)));
+        }
+        powerDbRangeFast(fft + i, real + i, size - i, scale);
+    }
+
+    // Eight samples per iteration: lo holds samples 0-3 and hi 4-7, each as
+    // interleaved I/Q, scaled by the window duplicated across I and Q.
+    template <SampleFormat::Type Format, bool Windowed>
+    __attribute__((target("avx2,fma"))) void convertRangeAvx2(const void *in, float scale, const float *window, std::complex<float> *out, size_t size)
+    {
+        float *iq = reinterpret_cast<float *>(out);
+        const __m256 vscale = _mm256_set1_ps(scale);
+        const __m256i lowPairs = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+        const __m256i highPairs = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            __m256 lo;
+            __m256 hi;
+            if constexpr (Format == SampleFormat::Type::CS16)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(static_cast<const int16_t *>(in) + 2 * i));
+                lo = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(v)));
+                hi = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(v, 1)));
+            }
+            else if constexpr (Format == SampleFormat::Type::CS8)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(static_cast<const int8_t *>(in) + 2 * i));
+                lo = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(v));
+                hi = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(v, 8)));
+            }
+            else if constexpr (Format == SampleFormat::Type::CU8)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(static_cast<const uint8_t *>(in) + 2 * i));
+                const __m256 offset = _mm256_set1_ps(CU8_OFFSET);
+                lo = _mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v)), offset);
+                hi = _mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(v, 8))), offset);
+            }
+            else
+            {
+                lo = _mm256_loadu_ps(static_cast<const float *>(in) + 2 * i);
+                hi = _mm256_loadu_ps(static_cast<const float *>(in) + 2 * i + 8);
+            }
+
+            __m256 gainLo = vscale;
+            __m256 gainHi = vscale;
+            if constexpr (Windowed)
+            {
+                __m256 w = _mm256_mul_ps(_mm256_loadu_ps(window + i), vscale);
+                gainLo = _mm256_permutevar8x32_ps(w, lowPairs);
+                gainHi = _mm256_permutevar8x32_ps(w, highPairs);
+            }
+            _mm256_storeu_ps(iq + 2 * i, _mm256_mul_ps(lo, gainLo));
+            _mm256_storeu_ps(iq + 2 * i + 8, _mm256_mul_ps(hi, gainHi));
+        }
+        convertRangeScalar<Format, Windowed>(advance(in, Format, i), scale, Windowed ? window + i : window, out + i, size - i);
+    }
+
+    template <bool Windowed>
+    void avx2ConvertKernels(ConvertKernel *kernels)
+    {
+        kernels[static_cast<size_t>(SampleFormat::Type::CF32)] = convertRangeAvx2<SampleFormat::Type::CF32, Windowed>;
+        kernels[static_cast<size_t>(SampleFormat::Type::CS16)] = convertRangeAvx2<SampleFormat::Type::CS16, Windowed>;
+        kernels[static_cast<size_t>(SampleFormat::Type::CS8)] = convertRangeAvx2<SampleFormat::Type::CS8, Windowed>;
+        kernels[static_cast<size_t>(SampleFormat::Type::CU8)] = convertRangeAvx2<SampleFormat::Type::CU8, Windowed>;
+    }
+
+    __attribute__((target("avx2,fma"))) void toDbRangeAvx2(const float *power, float *real, size_t size, float scale)
+    {
+        const __m256 vscale = _mm256_set1_ps(scale);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            _mm256_storeu_ps(real + i, fastDbAvx2(_mm256_mul_ps(_mm256_loadu_ps(power + i), vscale)));
+        }
+        toDbRangeFast(power + i, real + i, size - i, scale);
+    }
+
+    __attribute__((target("avx2,fma"))) void cauchyTailRangeAvx2(const float *x, const float *x0, const float *sigma, const float *lambda, float *p, size_t size)
+    {
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 epsilon = _mm256_set1_ps(SIGN_EPSILON);
+        const __m256 signBit = _mm256_set1_ps(-0.0f);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            __m256 r = _mm256_sub_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(x0 + i));
+            __m256 l = _mm256_loadu_ps(lambda + i);
+            __m256 sign = _mm256_sub_ps(_mm256_and_ps(_mm256_cmp_ps(r, epsilon, _CMP_GT_OQ), one),
+                                        _mm256_and_ps(_mm256_cmp_ps(r, epsilon, _CMP_LT_OQ), one));
+            __m256 k = _mm256_fmadd_ps(sign, l, one);
+            __m256 z = _mm256_div_ps(r, _mm256_mul_ps(_mm256_loadu_ps(sigma + i), k));
+
+            __m256 a = _mm256_andnot_ps(signBit, z);
+            __m256 folded = _mm256_cmp_ps(a, one, _CMP_GT_OQ);
+            __m256 t = _mm256_blendv_ps(a, _mm256_div_ps(one, a), folded);
+            __m256 t2 = _mm256_mul_ps(t, t);
+            __m256 poly = _mm256_fmadd_ps(t2, _mm256_set1_ps(ATAN_C11), _mm256_set1_ps(ATAN_C9));
+            poly = _mm256_fmadd_ps(t2, poly, _mm256_set1_ps(ATAN_C7));
+            poly = _mm256_fmadd_ps(t2, poly, _mm256_set1_ps(ATAN_C5));
+            poly = _mm256_fmadd_ps(t2, poly, _mm256_set1_ps(ATAN_C3));
+            poly = _mm256_fmadd_ps(t2, poly, _mm256_set1_ps(ATAN_C1));
+            poly = _mm256_mul_ps(t, poly);
+            poly = _mm256_blendv_ps(poly, _mm256_sub_ps(_mm256_set1_ps(HALF_PI), poly), folded);
+            __m256 angle = _mm256_or_ps(poly, _mm256_and_ps(z, signBit));
+
+            __m256 half = _mm256_mul_ps(_mm256_set1_ps(0.5f), _mm256_add_ps(one, l));
+            _mm256_storeu_ps(p + i, _mm256_fnmadd_ps(_mm256_mul_ps(k, _mm256_set1_ps(INV_PI)), angle, half));
+        }
+        cauchyTailRange<true>(x + i, x0 + i, sigma + i, lambda + i, p + i, size - i);
+    }
+#elif defined(DSP_KERNELS_NEON)
+    inline float32x4_t fastDbNeon(float32x4_t x)
+    {
+        x = vmaxq_f32(x, vdupq_n_f32(FLT_MIN));
+        uint32x4_t bits = vreinterpretq_u32_f32(x);
+        float32x4_t e = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127)));
+        float32x4_t m = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007FFFFF)),
+                                                        vdupq_n_u32(0x3F800000)));
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        float32x4_t t = vdivq_f32(vsubq_f32(m, one), vaddq_f32(m, one));
+        float32x4_t t2 = vmulq_f32(t, t);
+        float32x4_t poly = vfmaq_f32(vdupq_n_f32(1.0f / 5.0f), t2, vdupq_n_f32(1.0f / 7.0f));
+        poly = vfmaq_f32(vdupq_n_f32(1.0f / 3.0f), t2, poly);
+        poly = vfmaq_f32(one, t2, poly);
+        poly = vmulq_f32(t, poly);
+        float32x4_t log2x = vfmaq_f32(e, vdupq_n_f32(TWO_OVER_LN2), poly);
+        return vmulq_f32(vdupq_n_f32(DB_PER_OCTAVE), log2x);
+    }
+
+    void powerDbRangeNeon(const std::complex<float> *fft, float *real, size_t size, float scale)
+    {
+        const float *in = reinterpret_cast<const float *>(fft);
+        const float32x4_t vscale = vdupq_n_f32(scale);
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4)
+        {
+            float32x4x2_t iq = vld2q_f32(in + 2 * i);
+            float32x4_t p = vfmaq_f32(vmulq_f32(iq.val[0], iq.val[0]), iq.val[1], iq.val[1]);
+            vst1q_f32(real + i, fastDbNeon(vmulq_f32(p, vscale)));
+        }
+        powerDbRangeFast(fft + i, real + i, size - i, scale);
+    }
+
+    // Four samples per iteration: lo holds samples 0-1 and hi 2-3.
+    template <SampleFormat::Type Format, bool Windowed>
+    void convertRangeNeon(const void *in, float scale, const float *window, std::complex<float> *out, size_t size)
+    {
+        float *iq = reinterpret_cast<float *>(out);
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4)
+        {
+            float32x4_t lo;
+            float32x4_t hi;
+            if constexpr (Format == SampleFormat::Type::CS16)
+            {
+                int16x8_t v = vld1q_s16(static_cast<const int16_t *>(in) + 2 * i);
+                lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+                hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+            }
+            else if constexpr (Format == SampleFormat::Type::CS8)
+            {
+                int16x8_t v = vmovl_s8(vld1_s8(static_cast<const int8_t *>(in) + 2 * i));
+                lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+                hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+            }
+            else if constexpr (Format == SampleFormat::Type::CU8)
+            {
+                uint16x8_t v = vmovl_u8(vld1_u8(static_cast<const uint8_t *>(in) + 2 * i));
+                const float32x4_t offset = vdupq_n_f32(CU8_OFFSET);
+                lo = vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))), offset);
+                hi = vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))), offset);
+            }
+            else
+            {
+                lo = vld1q_f32(static_cast<const float *>(in) + 2 * i);
+                hi = vld1q_f32(static_cast<const float *>(in) + 2 * i + 4);
+            }
+
+            float32x4_t gainLo = vdupq_n_f32(scale);
+            float32x4_t gainHi = gainLo;
+            if constexpr (Windowed)
+            {
+                float32x4_t w = vmulq_n_f32(vld1q_f32(window + i), scale);
+                float32x4x2_t pairs = vzipq_f32(w, w);
+                gainLo = pairs.val[0];
+                gainHi = pairs.val[1];
+            }
+            vst1q_f32(iq + 2 * i, vmulq_f32(lo, gainLo));
+            vst1q_f32(iq + 2 * i + 4, vmulq_f32(hi, gainHi));
+        }
+        convertRangeScalar<Format, Windowed>(advance(in, Format, i), scale, Windowed ? window + i : window, out + i, size - i);
+    }
+
+    template <bool Windowed>
+    void neonConvertKernels(ConvertKernel *kernels)
+    {
+        kernels[static_cast<size_t>(SampleFormat::Type::CF32)] = convertRangeNeon<SampleFormat::Type::CF32, Windowed>;
+        kernels[static_cast<size_t>(SampleFormat::Type::CS16)] = convertRangeNeon<SampleFormat::Type::CS16, Windowed>;
+        kernels[static_cast<size_t>(SampleFormat::Type::CS8)] = convertRangeNeon<SampleFormat::Type::CS8, Windowed>;
+        kernels[static_cast<size_t>(SampleFormat::Type::CU8)] = convertRangeNeon<SampleFormat::Type::CU8, Windowed>;
+    }
+
+    void toDbRangeNeon(const float *power, float *real, size_t size, float scale)
+    {
+        const float32x4_t vscale = vdupq_n_f32(scale);
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4)
+        {
+            vst1q_f32(real + i, fastDbNeon(vmulq_f32(vld1q_f32(power + i), vscale)));
+        }
+        toDbRangeFast(power + i, real + i, size - i, scale);
+    }
+
+    void cauchyTailRangeNeon(const float *x, const float *x0, const float *sigma, const float *lambda, float *p, size_t size)
+    {
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t epsilon = vdupq_n_f32(SIGN_EPSILON);
+        const uint32x4_t signBit = vdupq_n_u32(0x80000000u);
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4)
+        {
+            float32x4_t r = vsubq_f32(vld1q_f32(x + i), vld1q_f32(x0 + i));
+            float32x4_t l = vld1q_f32(lambda + i);
+            float32x4_t positive = vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(r, epsilon), vreinterpretq_u32_f32(one)));
+            float32x4_t negative = vreinterpretq_f32_u32(vandq_u32(vcltq_f32(r, epsilon), vreinterpretq_u32_f32(one)));
+            float32x4_t k = vfmaq_f32(one, vsubq_f32(positive, negative), l);
+            float32x4_t z = vdivq_f32(r, vmulq_f32(vld1q_f32(sigma + i), k));
+
+            float32x4_t a = vabsq_f32(z);
+            uint32x4_t folded = vcgtq_f32(a, one);
+            float32x4_t t = vbslq_f32(folded, vdivq_f32(one, a), a);
+            float32x4_t t2 = vmulq_f32(t, t);
+            float32x4_t poly = vfmaq_f32(vdupq_n_f32(ATAN_C9), t2, vdupq_n_f32(ATAN_C11));
+            poly = vfmaq_f32(vdupq_n_f32(ATAN_C7), t2, poly);
+            poly = vfmaq_f32(vdupq_n_f32(ATAN_C5), t2, poly);
+            poly = vfmaq_f32(vdupq_n_f32(ATAN_C3), t2, poly);
+            poly = vfmaq_f32(vdupq_n_f32(ATAN_C1), t2, poly);
+            poly = vmulq_f32(t, poly);
+            poly = vbslq_f32(folded, vsubq_f32(vdupq_n_f32(HALF_PI), poly), poly);
+            float32x4_t angle = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(poly),
+                                                                vandq_u32(vreinterpretq_u32_f32(z), signBit)));
+
+            float32x4_t half = vmulq_f32(vdupq_n_f32(0.5f), vaddq_f32(one, l));
+            vst1q_f32(p + i, vfmsq_f32(half, vmulq_f32(k, vdupq_n_f32(INV_PI)), angle));
+        }
+        cauchyTailRange<true>(x + i, x0 + i, sigma + i, lambda + i, p + i, size - i);
+    }
+#endif
+
+    struct Dispatch
+    {
+        ComplexKernel powerDb = powerDbRangeFast;
+        RealKernel toDb = toDbRangeFast;
+        TailKernel cauchyTail = cauchyTailRange<true>;
+        ConvertKernel convert[FORMAT_COUNT];
+        ConvertKernel convertWindow[FORMAT_COUNT];
+        const char *isa = "scalar";
+
+        Dispatch()
+        {
+            scalarConvertKernels<false>(convert);
+            scalarConvertKernels<true>(convertWindow);
+#if defined(DSP_KERNELS_X86)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            {
+                powerDb = powerDbRangeAvx2;
+                toDb = toDbRangeAvx2;
+                cauchyTail = cauchyTailRangeAvx2;
+                avx2ConvertKernels<false>(convert);
+                avx2ConvertKernels<true>(convertWindow);
+                isa = "avx2";
+            }
+#elif defined(DSP_KERNELS_NEON)
+            powerDb = powerDbRangeNeon;
+            toDb = toDbRangeNeon;
+            cauchyTail = cauchyTailRangeNeon;
+            neonConvertKernels<false>(convert);
+            neonConvertKernels<true>(convertWindow);
+            isa = "neon";
+#endif
+        }
+    };
+
+    const Dispatch &dispatch()
+    {
+        static const Dispatch d;
+        return d;
+    }
+
+    // Runs a range kernel so the output comes out fftshifted: the upper half
+    // of the input lands in the lower half of the output and vice versa.
+    template <typename In, typename Kernel>
+    void shifted(Kernel kernel, const In *in, float *out, size_t size, float scale)
+    {
+        size_t mid = size / 2;
+        kernel(in + mid, out, mid, scale);
+        kernel(in, out + mid, mid, scale);
+        if (size % 2 != 0)
+        {
+            kernel(in + size - 1, out + size - 1, 1, scale);
+        }
+    }
+}
+
+void SpectralKernels::applyWindow(std::complex<float> *in, const float *window, size_t size)
+{
+    float *iq = reinterpret_cast<float *>(in);
+    for (size_t i = 0; i < size; i++)
+    {
+        iq[2 * i] *= window[i];
+        iq[2 * i + 1] *= window[i];
+    }
+}
+
+void SpectralKernels::convert(const void *in, const SampleFormat &format, std::complex<float> *out, size_t size)
+{
+    if (format.type == SampleFormat::Type::CF32 && format.scale == 1.0f)
+    {
+        if (in != out)
+        {
+            std::memmove(out, in, size * sizeof(std::complex<float>));
+        }
+        return;
+    }
+    dispatch().convert[static_cast<size_t>(format.type)](in, format.scale, nullptr, out, size);
+}
+
+void SpectralKernels::convertWindow(const void *in, const SampleFormat &format, const float *window, std::complex<float> *out, size_t size)
+{
+    dispatch().convertWindow[static_cast<size_t>(format.type)](in, format.scale, window, out, size);
+}
+
+void SpectralKernels::convertWindowScalar(const void *in, const SampleFormat &format, const float *window, std::complex<float> *out, size_t size)
+{
+    ConvertKernel kernels[FORMAT_COUNT];
+    scalarConvertKernels<true>(kernels);
+    kernels[static_cast<size_t>(format.type)](in, format.scale, window, out, size);
+}
+
+void SpectralKernels::powerDb(const std::complex<float> *fft, float *real, size_t size, float scale)
+{
+    shifted(dispatch().powerDb, fft, real, size, scale);
+}
+
+void SpectralKernels::powerDbScalar(const std::complex<float> *fft, float *real, size_t size, float scale)
+{
+    shifted(powerDbRangeScalar, fft, real, size, scale);
+}
+
+void SpectralKernels::toDb(const float *power, float *real, size_t size, float scale)
+{
+    shifted(dispatch().toDb, power, real, size, scale);
+}
+
+void SpectralKernels::toDbScalar(const float *power, float *real, size_t size, float scale)
+{
+    shifted(toDbRangeScalar, power, real, size, scale);
+}
+
+void SpectralKernels::cauchyTail(const float *x, const float *x0, const float *sigma, const float *lambda, float *p, size_t size)
+{
+    dispatch().cauchyTail(x, x0, sigma, lambda, p, size);
+}
+
+void SpectralKernels::cauchyTailScalar(const float *x, const float *x0, const float *sigma, const float *lambda, float *p, size_t size)
+{
+    cauchyTailRange<false>(x, x0, sigma, lambda, p, size);
+}
+
+const char *SpectralKernels::isa()
+{
+    return dispatch().isa;
+}
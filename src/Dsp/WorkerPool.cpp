@@ -0,0 +1,108 @@
+#include <stdexcept>
+
+#include "Dsp/WorkerPool.hpp"
+
+using namespace Dsp;
+
+WorkerPool::WorkerPool(size_t threads)
+{
+    if (threads == 0)
+    {
+        throw std::runtime_error("Worker pool needs at least one thread");
+    }
+
+    m_workers.reserve(threads - 1);
+    for (size_t i = 1; i < threads; i++)
+    {
+        m_workers.emplace_back([this, i]()
+                               { workerMain(i); });
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto &worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+size_t WorkerPool::getThreadCount() const
+{
+    return m_workers.size() + 1;
+}
+
+void WorkerPool::slice(size_t participant, size_t &begin, size_t &end) const
+{
+    // The first count % threads participants take one extra item.
+    const size_t threads = m_workers.size() + 1;
+    const size_t base = m_count / threads;
+    const size_t extra = m_count % threads;
+    begin = participant * base + std::min(participant, extra);
+    end = begin + base + (participant < extra ? 1 : 0);
+}
+
+void WorkerPool::run(size_t count, const Task &task)
+{
+    if (m_workers.empty() == true || count < 2)
+    {
+        task(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_count = count;
+        m_pending = m_workers.size();
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    size_t begin;
+    size_t end;
+    slice(0, begin, end);
+    task(begin, end);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]()
+                { return m_pending == 0; });
+    m_task = nullptr;
+}
+
+void WorkerPool::workerMain(size_t index)
+{
+    uint64_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, seen]()
+                        { return m_stopping == true || m_generation != seen; });
+            if (m_stopping == true)
+            {
+                return;
+            }
+            seen = m_generation;
+        }
+
+        size_t begin;
+        size_t end;
+        slice(index, begin, end);
+        if (begin < end)
+        {
+            (*m_task)(begin, end);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pending == 0)
+        {
+            m_done.notify_one();
+        }
+    }
+}
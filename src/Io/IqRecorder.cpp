@@ -0,0 +1,569 @@
+#include <ctime>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#if defined(IO_HAVE_LIBURING)
+#include <liburing.h>
+#endif
+
+#include "Io/IqRecorder.hpp"
+
+using namespace Io;
+
+namespace
+{
+    const std::chrono::milliseconds IDLE_POLL_INTERVAL(100);
+    const std::chrono::microseconds BUSY_POLL_INTERVAL(500);
+
+    const char *sigmfDatatype(Dsp::SampleFormat::Type type)
+    {
+        switch (type)
+        {
+        case Dsp::SampleFormat::Type::CS16:
+            return "ci16_le";
+        case Dsp::SampleFormat::Type::CS8:
+            return "ci8";
+        case Dsp::SampleFormat::Type::CU8:
+            return "cu8";
+        default:
+            return "cf32_le";
+        }
+    }
+
+    // ISO 8601 UTC with nanoseconds, as core:datetime wants.
+    std::string isoTime(int64_t timeNs)
+    {
+        time_t seconds = static_cast<time_t>(timeNs / 1000000000);
+        long nanoseconds = static_cast<long>(timeNs % 1000000000);
+        if (nanoseconds < 0)
+        {
+            seconds -= 1;
+            nanoseconds += 1000000000;
+        }
+
+        struct tm utc;
+        gmtime_r(&seconds, &utc);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &utc);
+        char text[48];
+        std::snprintf(text, sizeof(text), "%s.%09ldZ", date, nanoseconds);
+        return text;
+    }
+
+    size_t alignUp(size_t bytes)
+    {
+        return (bytes + IqRecorder::ALIGNMENT - 1) / IqRecorder::ALIGNMENT * IqRecorder::ALIGNMENT;
+    }
+}
+
+IqRecorder::IqRecorder(const std::string &prefix, const Dsp::SampleFormat &format, double sampleRate,
+                       double preTriggerS, double postTriggerS)
+    : m_prefix(prefix),
+      m_format(format),
+      m_sampleRate(sampleRate),
+      m_sampleBytes(format.bytesPerSample())
+{
+    if (sampleRate <= 0 || preTriggerS < 0 || postTriggerS < 0)
+    {
+        throw std::runtime_error("Invalid IQ recorder configuration");
+    }
+
+    m_preBytes = static_cast<size_t>(preTriggerS * sampleRate) * m_sampleBytes;
+    m_postBytes = static_cast<size_t>(postTriggerS * sampleRate) * m_sampleBytes;
+
+    // The history, plus as much again (at least a few queues of writes) for
+    // the writer to fall behind by before blocks are dropped.
+    const size_t slack = std::max(m_preBytes, static_cast<size_t>(4 * QUEUE_DEPTH) * WRITE_BYTES);
+    m_capacity = alignUp(m_preBytes + slack);
+    void *ring = mmap(nullptr, m_capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED)
+    {
+        throw std::runtime_error("Failed to allocate the IQ recorder ring");
+    }
+    m_ring = static_cast<uint8_t *>(ring);
+
+#if defined(IO_HAVE_LIBURING)
+    // Without a ring, for example under a seccomp policy that blocks
+    // io_uring, the writer falls back to blocking pwrite().
+    m_uring = new io_uring;
+    if (io_uring_queue_init(QUEUE_DEPTH, m_uring, 0) < 0)
+    {
+        delete m_uring;
+        m_uring = nullptr;
+    }
+#endif
+
+    m_writer = std::thread([this]()
+                           { writerMain(); });
+}
+
+IqRecorder::~IqRecorder()
+{
+    // The writer finishes any open recording with what has been pushed.
+    m_running.store(false);
+    m_wake.notify_one();
+    m_writer.join();
+
+#if defined(IO_HAVE_LIBURING)
+    if (m_uring != nullptr)
+    {
+        io_uring_queue_exit(m_uring);
+        delete m_uring;
+    }
+#endif
+    munmap(m_ring, m_capacity);
+}
+
+void IqRecorder::push(const void *samples, size_t count, int64_t timeNs, double frequency)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    const uint64_t head = m_head.load(std::memory_order_relaxed);
+    if (m_pendingTrigger == true && m_tail.load(std::memory_order_acquire) == NONE)
+    {
+        m_pendingTrigger = false;
+        start(head);
+    }
+
+    // Never overwrite what the writer still needs; drop instead of waiting.
+    const size_t bytes = count * m_sampleBytes;
+    const uint64_t tail = m_tail.load(std::memory_order_acquire);
+    if (bytes > m_capacity || (tail != NONE && head + bytes - tail > m_capacity))
+    {
+        m_droppedSamples.fetch_add(count, std::memory_order_relaxed);
+        m_gap = true;
+        return;
+    }
+
+    const int64_t drift = timeNs - m_expectedNs;
+    if (m_gap == true || frequency != m_lastFrequency || drift > GAP_TOLERANCE_NS || drift < -GAP_TOLERANCE_NS)
+    {
+        m_events.push(Event{Event::Type::Segment, head, timeNs, frequency});
+        m_lastFrequency = frequency;
+        m_gap = false;
+    }
+
+    const size_t offset = head % m_capacity;
+    const size_t first = std::min(bytes, m_capacity - offset);
+    std::memcpy(m_ring + offset, samples, first);
+    std::memcpy(m_ring, static_cast<const uint8_t *>(samples) + first, bytes - first);
+    m_head.store(head + bytes, std::memory_order_release);
+    m_expectedNs = timeNs + static_cast<int64_t>(static_cast<double>(count) * 1e9 / m_sampleRate);
+}
+
+bool IqRecorder::trigger()
+{
+    const uint64_t head = m_head.load(std::memory_order_relaxed);
+    m_events.push(Event{Event::Type::Trigger, head, 0, 0});
+
+    // Extend the open recording unless the writer has just closed it.
+    uint64_t end = m_end.load(std::memory_order_acquire);
+    while (end != 0)
+    {
+        if (m_end.compare_exchange_weak(end, std::max<uint64_t>(end, head + m_postBytes),
+                                        std::memory_order_acq_rel, std::memory_order_acquire) == true)
+        {
+            return false;
+        }
+    }
+    return start(head);
+}
+
+bool IqRecorder::start(uint64_t head)
+{
+    // The writer is still finishing the previous recording; the next push()
+    // starts this one once it is done.
+    if (m_tail.load(std::memory_order_acquire) != NONE)
+    {
+        m_pendingTrigger = true;
+        return false;
+    }
+
+    // m_end == 0 means no recording, so there must be something to record.
+    if (head + m_postBytes == 0)
+    {
+        return false;
+    }
+
+    // O_DIRECT needs the file and the ring to line up on ALIGNMENT.
+    uint64_t first = head > m_preBytes ? head - m_preBytes : 0;
+    first -= first % ALIGNMENT;
+    m_tail.store(first, std::memory_order_release);
+    m_end.store(head + m_postBytes, std::memory_order_release);
+    m_wake.notify_one();
+    return true;
+}
+
+bool IqRecorder::isRecording() const
+{
+    return m_tail.load(std::memory_order_acquire) != NONE;
+}
+
+uint64_t IqRecorder::getRecordingCount() const
+{
+    return m_recordings.load(std::memory_order_relaxed);
+}
+
+uint64_t IqRecorder::getFailedCount() const
+{
+    return m_failed.load(std::memory_order_relaxed);
+}
+
+uint64_t IqRecorder::getDroppedSampleCount() const
+{
+    return m_droppedSamples.load(std::memory_order_relaxed);
+}
+
+void IqRecorder::writerMain()
+{
+    while (true)
+    {
+        drainEvents();
+        const bool running = m_running.load();
+
+        if (m_fd < 0)
+        {
+            if (m_end.load(std::memory_order_acquire) != 0)
+            {
+                open(m_tail.load(std::memory_order_acquire));
+                continue;
+            }
+            if (running == false)
+            {
+                return;
+            }
+
+            // Forget segments and triggers that have left the ring, keeping
+            // the segment the oldest byte still belongs to.
+            const uint64_t head = m_head.load(std::memory_order_acquire);
+            const uint64_t oldest = head > m_capacity ? head - m_capacity : 0;
+            while (m_segments.size() > 1 && m_segments[1].position <= oldest)
+            {
+                m_segments.pop_front();
+            }
+            m_triggers.erase(std::remove_if(m_triggers.begin(), m_triggers.end(), [oldest](uint64_t position)
+                                            { return position < oldest; }),
+                             m_triggers.end());
+
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wake.wait_for(lock, IDLE_POLL_INTERVAL);
+            continue;
+        }
+
+        if (reap(false) == false)
+        {
+            close(m_submitted, true);
+            continue;
+        }
+
+        uint64_t end = m_end.load(std::memory_order_acquire);
+        const uint64_t head = m_head.load(std::memory_order_acquire);
+        const uint64_t limit = std::min(head, end);
+        const bool complete = head >= end || running == false;
+
+        // Whole WRITE_BYTES writes, cut short only at the end of the ring or
+        // of the recording.
+        bool submitted = false;
+        bool failed = false;
+        while (m_inFlight.size() < QUEUE_DEPTH)
+        {
+            const size_t room = m_capacity - m_submitted % m_capacity;
+            size_t bytes = std::min<uint64_t>({limit - m_submitted, static_cast<uint64_t>(WRITE_BYTES), room});
+            bytes -= bytes % ALIGNMENT;
+            if (bytes == 0 || (bytes < WRITE_BYTES && bytes < room && complete == false))
+            {
+                break;
+            }
+            if (submit(m_submitted, bytes) == false)
+            {
+                failed = true;
+                break;
+            }
+            m_submitted += bytes;
+            submitted = true;
+        }
+        if (failed == true)
+        {
+            close(m_submitted, true);
+            continue;
+        }
+
+        if (complete == true && limit - m_submitted < ALIGNMENT)
+        {
+            // Close before the padded final write, so a trigger arriving now
+            // starts a new recording instead of extending this one.
+            if (running == false)
+            {
+                m_end.store(0, std::memory_order_release);
+                close(limit, false);
+            }
+            else if (m_end.compare_exchange_strong(end, 0, std::memory_order_acq_rel) == true)
+            {
+                close(limit, false);
+            }
+            continue;
+        }
+
+        if (submitted == false)
+        {
+            if (m_inFlight.empty() == false)
+            {
+                if (reap(true) == false)
+                {
+                    close(m_submitted, true);
+                }
+            }
+            else
+            {
+                std::this_thread::sleep_for(BUSY_POLL_INTERVAL);
+            }
+        }
+    }
+}
+
+void IqRecorder::drainEvents()
+{
+    m_events.drain([this](Event &event)
+                   {
+                       if (event.type == Event::Type::Segment)
+                       {
+                           m_segments.push_back(event);
+                       }
+                       else
+                       {
+                           m_triggers.push_back(event.position);
+                       }
+                   });
+}
+
+void IqRecorder::open(uint64_t start)
+{
+    // Segments pushed before the trigger name and time the file.
+    drainEvents();
+    m_start = start;
+    m_submitted = start;
+    m_fileName = m_prefix + std::to_string(timeAt(start));
+
+    // Filesystems without O_DIRECT, such as tmpfs, get buffered writes.
+    const std::string dataFile = m_fileName + ".sigmf-data";
+    m_fd = ::open(dataFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+    if (m_fd < 0 && errno == EINVAL)
+    {
+        m_fd = ::open(dataFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    if (m_fd < 0)
+    {
+        m_failed.fetch_add(1, std::memory_order_relaxed);
+        m_end.store(0, std::memory_order_release);
+        m_tail.store(NONE, std::memory_order_release);
+    }
+}
+
+bool IqRecorder::submit(uint64_t position, size_t bytes)
+{
+    const uint8_t *buffer = m_ring + position % m_capacity;
+    const off_t offset = static_cast<off_t>(position - m_start);
+
+#if defined(IO_HAVE_LIBURING)
+    if (m_uring != nullptr)
+    {
+        io_uring_sqe *sqe = io_uring_get_sqe(m_uring);
+        if (sqe == nullptr)
+        {
+            return false;
+        }
+        io_uring_prep_write(sqe, m_fd, buffer, static_cast<unsigned>(bytes), offset);
+        sqe->user_data = position;
+        if (io_uring_submit(m_uring) < 0)
+        {
+            return false;
+        }
+        m_inFlight.push_back(Write{position, bytes, false});
+        return true;
+    }
+#endif
+
+    ssize_t written = pwrite(m_fd, buffer, bytes, offset);
+    m_inFlight.push_back(Write{position, bytes, true});
+    return written == static_cast<ssize_t>(bytes);
+}
+
+bool IqRecorder::reap(bool wait)
+{
+    bool ok = true;
+#if defined(IO_HAVE_LIBURING)
+    if (m_uring != nullptr)
+    {
+        io_uring_cqe *cqe = nullptr;
+        int ret = wait == true ? io_uring_wait_cqe(m_uring, &cqe) : io_uring_peek_cqe(m_uring, &cqe);
+        while (ret == 0 && cqe != nullptr)
+        {
+            for (Write &write : m_inFlight)
+            {
+                if (write.position == cqe->user_data)
+                {
+                    write.done = true;
+                    ok &= cqe->res == static_cast<int>(write.bytes);
+                    break;
+                }
+            }
+            io_uring_cqe_seen(m_uring, cqe);
+            ret = io_uring_peek_cqe(m_uring, &cqe);
+        }
+    }
+#else
+    (void)wait;
+#endif
+
+    // Writes complete out of order; the tail only moves past a contiguous
+    // run of finished ones.
+    while (m_inFlight.empty() == false && m_inFlight.front().done == true)
+    {
+        m_tail.store(m_inFlight.front().position + m_inFlight.front().bytes, std::memory_order_release);
+        m_inFlight.pop_front();
+    }
+    return ok;
+}
+
+void IqRecorder::close(uint64_t end, bool failed)
+{
+    while (m_inFlight.empty() == false)
+    {
+        failed |= reap(true) == false;
+    }
+
+    // The last partial block goes out padded to ALIGNMENT and is cut back
+    // to the exact length afterwards. The padding is ring memory the
+    // pushing thread cannot be writing, as the tail still protects it.
+    if (failed == false && end > m_submitted)
+    {
+        failed = submit(m_submitted, ALIGNMENT) == false;
+        while (m_inFlight.empty() == false)
+        {
+            failed |= reap(true) == false;
+        }
+    }
+
+    const std::string dataFile = m_fileName + ".sigmf-data";
+    if (failed == false)
+    {
+        failed = ftruncate(m_fd, static_cast<off_t>(end - m_start)) != 0;
+    }
+    ::close(m_fd);
+    m_fd = -1;
+
+    if (failed == true)
+    {
+        std::remove(dataFile.c_str());
+        m_failed.fetch_add(1, std::memory_order_relaxed);
+        m_end.store(0, std::memory_order_release);
+    }
+    else
+    {
+        drainEvents();
+        writeMetadata(m_start, end, m_fileName);
+        m_recordings.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // A trigger right at the end also opens the next recording.
+    m_triggers.erase(std::remove_if(m_triggers.begin(), m_triggers.end(), [end](uint64_t position)
+                                    { return position < end; }),
+                     m_triggers.end());
+    m_tail.store(NONE, std::memory_order_release);
+}
+
+int64_t IqRecorder::timeAt(uint64_t position) const
+{
+    for (auto it = m_segments.rbegin(); it != m_segments.rend(); ++it)
+    {
+        if (it->position <= position)
+        {
+            double samples = static_cast<double>((position - it->position) / m_sampleBytes);
+            return it->timeNs + static_cast<int64_t>(samples * 1e9 / m_sampleRate);
+        }
+    }
+    return 0;
+}
+
+void IqRecorder::writeMetadata(uint64_t start, uint64_t end, const std::string &fileName) const
+{
+    char line[512];
+    std::string json = "{\n  \"global\": {\n";
+    std::snprintf(line, sizeof(line),
+                  "    \"core:datatype\": \"%s\",\n"
+                  "    \"core:sample_rate\": %.17g,\n"
+                  "    \"core:num_channels\": 1,\n"
+                  "    \"core:version\": \"1.0.0\",\n"
+                  "    \"core:extensions\": [{\"name\": \"sdr\", \"version\": \"1.0.0\", \"optional\": true}],\n"
+                  "    \"sdr:scale\": %.9g\n  },\n",
+                  sigmfDatatype(m_format.type), m_sampleRate, m_format.scale);
+    json += line;
+
+    // One capture per stretch of contiguous samples at one frequency; the
+    // first covers the pre-trigger history from the start of the file.
+    json += "  \"captures\": [";
+    bool first = true;
+    for (size_t i = 0; i < m_segments.size(); i++)
+    {
+        const Event &segment = m_segments[i];
+        bool last = i + 1 == m_segments.size() || m_segments[i + 1].position > start;
+        if (segment.position >= end || (segment.position < start && last == false))
+        {
+            continue;
+        }
+
+        uint64_t position = std::max(segment.position, start);
+        int64_t timeNs = timeAt(position);
+        std::snprintf(line, sizeof(line),
+                      "%s\n    {\"core:sample_start\": %llu, \"core:frequency\": %.17g, \"core:datetime\": \"%s\", \"sdr:time_ns\": %lld}",
+                      first ? "" : ",",
+                      static_cast<unsigned long long>((position - start) / m_sampleBytes),
+                      segment.frequency,
+                      isoTime(timeNs).c_str(),
+                      static_cast<long long>(timeNs));
+        json += line;
+        first = false;
+    }
+    json += "\n  ],\n  \"annotations\": [";
+
+    first = true;
+    for (uint64_t position : m_triggers)
+    {
+        if (position < start || position > end)
+        {
+            continue;
+        }
+        std::snprintf(line, sizeof(line),
+                      "%s\n    {\"core:sample_start\": %llu, \"core:label\": \"anomaly\", \"sdr:time_ns\": %lld}",
+                      first ? "" : ",",
+                      static_cast<unsigned long long>((position - start) / m_sampleBytes),
+                      static_cast<long long>(timeAt(position)));
+        json += line;
+        first = false;
+    }
+    json += "\n  ]\n}\n";
+
+    std::string metaFile = fileName + ".sigmf-meta";
+    std::string tempFile = metaFile + ".tmp";
+    std::ofstream os(tempFile, std::ios::trunc);
+    if (os.is_open())
+    {
+        os << json;
+        os.flush();
+        os.close();
+
+        std::rename(tempFile.c_str(), metaFile.c_str());
+    }
+}
@@ -0,0 +1,168 @@
+#include <cmath>
+#include <tuple>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "Io/ModelStore.hpp"
+
+using namespace Io;
+
+namespace
+{
+    const char *const HEADER = "# sdr-model-store";
+}
+
+ModelStore::ModelStore(const std::string &fileName) : m_fileName(fileName),
+                                                      m_lastSave(std::chrono::steady_clock::now()) {}
+
+bool ModelStore::Key::operator<(const Key &rhs) const
+{
+    return std::tie(device, frequencyHz, gainDeciDb) < std::tie(rhs.device, rhs.frequencyHz, rhs.gainDeciDb);
+}
+
+ModelStore::Key ModelStore::makeKey(const std::string &device, double frequency, double gain)
+{
+    // Fields are whitespace separated, so the id must not contain any.
+    std::string id = device;
+    for (auto &c : id)
+    {
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            c = '_';
+        }
+    }
+    return Key{id, std::llround(frequency), std::llround(gain * 10.0)};
+}
+
+bool ModelStore::load()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+
+    std::ifstream is(m_fileName);
+    if (is.is_open() == false)
+    {
+        return false;
+    }
+
+    // First line: "# sdr-model-store <version>".
+    std::string line;
+    std::getline(is, line);
+    std::istringstream header(line);
+    std::string hash, tag;
+    uint32_t version = 0;
+    header >> hash >> tag >> version;
+    if (hash + " " + tag != HEADER || version != VERSION)
+    {
+        return false;
+    }
+
+    // Then: device frequency_hz gain_ddb x0 sigma lambda samples updated_s
+    while (std::getline(is, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        Key key;
+        Entry entry;
+        if (fields >> key.device >> key.frequencyHz >> key.gainDeciDb >> entry.params.x0 >> entry.params.sigma >>
+            entry.params.lambda >> entry.samples >> entry.updatedS)
+        {
+            m_entries[key] = entry;
+        }
+    }
+    return true;
+}
+
+bool ModelStore::save()
+{
+    // Snapshot under the lock so devices are never stalled by the disk.
+    std::lock_guard<std::mutex> saveLock(m_saveMutex);
+    std::map<Key, Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        entries = m_entries;
+        m_dirty = false;
+        m_lastSave = std::chrono::steady_clock::now();
+    }
+
+    if (write(entries) == false)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_dirty = true;
+        return false;
+    }
+    return true;
+}
+
+bool ModelStore::flush()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_dirty == false || std::chrono::steady_clock::now() - m_lastSave < SAVE_INTERVAL)
+        {
+            return true;
+        }
+    }
+    return save();
+}
+
+bool ModelStore::write(const std::map<Key, Entry> &entries) const
+{
+    std::string temp_file = m_fileName + ".tmp";
+    std::ofstream os(temp_file, std::ios::trunc);
+    if (os.is_open() == false)
+    {
+        return false;
+    }
+
+    os.precision(17);
+    os << HEADER << ' ' << VERSION << '\n'
+       << "# device frequency_hz gain_ddb x0 sigma lambda samples updated_s\n";
+    for (auto &[key, entry] : entries)
+    {
+        os << key.device << ' ' << key.frequencyHz << ' ' << key.gainDeciDb << ' '
+           << entry.params.x0 << ' ' << entry.params.sigma << ' ' << entry.params.lambda << ' '
+           << entry.samples << ' ' << entry.updatedS << '\n';
+    }
+
+    os.flush();
+    if (os.good() == false)
+    {
+        return false;
+    }
+    os.close();
+
+    return std::rename(temp_file.c_str(), m_fileName.c_str()) == 0;
+}
+
+std::optional<ModelStore::Entry> ModelStore::find(const std::string &device, double frequency, double gain) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(makeKey(device, frequency, gain));
+    if (it == m_entries.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void ModelStore::put(const std::string &device, double frequency, double gain, const Model::CauchyParams &params, uint64_t samples)
+{
+    auto updated = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[makeKey(device, frequency, gain)] = Entry{params, samples, updated.count()};
+    m_dirty = true;
+}
+
+size_t ModelStore::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
@@ -0,0 +1,106 @@
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "Io/SpectrumRing.hpp"
+
+using namespace Io;
+
+static_assert(sizeof(SpectrumRing::FileHeader) == 64, "FileHeader layout is part of the file format");
+static_assert(sizeof(SpectrumRing::SlotHeader) == 64, "SlotHeader layout is part of the file format");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Seqlock needs lock-free 64-bit atomics");
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "Seqlock maps atomics onto the file");
+
+SpectrumRing::SpectrumRing(const std::string &fileName, uint32_t binCapacity, uint32_t slotCount)
+    : m_binCapacity(binCapacity),
+      m_slotCount(slotCount)
+{
+    if (binCapacity == 0 || slotCount == 0)
+    {
+        throw std::runtime_error("Invalid spectrum ring geometry");
+    }
+
+    const size_t slotBytes = sizeof(SlotHeader) + sizeof(float) * binCapacity;
+    m_slotSize = static_cast<uint32_t>((slotBytes + 63) / 64 * 64);
+    m_mapSize = sizeof(FileHeader) + static_cast<size_t>(m_slotSize) * slotCount;
+
+    m_fd = open(fileName.c_str(), O_RDWR | O_CREAT, 0644);
+    if (m_fd < 0)
+    {
+        throw std::runtime_error("Failed to open " + fileName);
+    }
+
+    if (ftruncate(m_fd, static_cast<off_t>(m_mapSize)) != 0)
+    {
+        close(m_fd);
+        throw std::runtime_error("Failed to size " + fileName);
+    }
+
+    void *map = mmap(nullptr, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (map == MAP_FAILED)
+    {
+        close(m_fd);
+        throw std::runtime_error("Failed to map " + fileName);
+    }
+    m_map = static_cast<uint8_t *>(map);
+
+    // Publish the geometry before the magic so a reader never sees a valid
+    // magic with stale sizes.
+    std::memset(m_map, 0, m_mapSize);
+    FileHeader *header = reinterpret_cast<FileHeader *>(m_map);
+    header->version = VERSION;
+    header->headerSize = sizeof(FileHeader);
+    header->slotSize = m_slotSize;
+    header->slotCount = m_slotCount;
+    header->binCapacity = m_binCapacity;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = MAGIC;
+}
+
+SpectrumRing::~SpectrumRing()
+{
+    if (m_map != nullptr)
+    {
+        munmap(m_map, m_mapSize);
+    }
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+    }
+}
+
+void SpectrumRing::write(double centerFrequency, double bandwidth, const float *bins, size_t count, int64_t timestampNs)
+{
+    count = std::min<size_t>(count, m_binCapacity);
+
+    FileHeader *header = reinterpret_cast<FileHeader *>(m_map);
+    auto *writeCount = reinterpret_cast<std::atomic<uint64_t> *>(&header->writeCount);
+    const uint64_t frame = writeCount->load(std::memory_order_relaxed);
+
+    uint8_t *slot = m_map + sizeof(FileHeader) + static_cast<size_t>(frame % m_slotCount) * m_slotSize;
+    SlotHeader *slotHeader = reinterpret_cast<SlotHeader *>(slot);
+    auto *sequence = reinterpret_cast<std::atomic<uint64_t> *>(&slotHeader->sequence);
+
+    const uint64_t seq = sequence->load(std::memory_order_relaxed);
+    sequence->store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slotHeader->timestampNs = timestampNs;
+    slotHeader->centerFrequency = centerFrequency;
+    slotHeader->bandwidth = bandwidth;
+    slotHeader->binCount = static_cast<uint32_t>(count);
+    std::memcpy(slot + sizeof(SlotHeader), bins, sizeof(float) * count);
+
+    sequence->store(seq + 2, std::memory_order_release);
+    writeCount->store(frame + 1, std::memory_order_release);
+}
+
+uint32_t SpectrumRing::getBinCapacity() const
+{
+    return m_binCapacity;
+}
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <SoapySDR/Device.hpp>
+
+#include "Sdr/BurstReader.hpp"
+
+using namespace Sdr;
+
+BurstReader::BurstReader(SoapySDR::Device &device,
+                         SoapySDR::Stream *stream,
+                         const Dsp::SampleFormat &format,
+                         PipelineMetrics &metrics,
+                         std::atomic<uint64_t> &samplesRead) : m_device(device),
+                                                               m_stream(stream),
+                                                               m_metrics(metrics),
+                                                               m_samplesRead(samplesRead),
+                                                               m_sampleBytes(format.bytesPerSample()) {}
+
+void BurstReader::setGeometry(size_t frameSize, size_t chunkSamples, double sampleRate)
+{
+    if (frameSize == 0 || sampleRate <= 0)
+    {
+        throw std::runtime_error("Invalid burst reader geometry");
+    }
+
+    size_t frames = std::max<size_t>(1, (chunkSamples + frameSize - 1) / frameSize);
+    size_t chunkSize = frames * frameSize;
+    if (chunkSize != m_chunkSize)
+    {
+        m_buffer.reset();
+        m_buffer = Dsp::FramePool::instance().acquire<uint8_t>(chunkSize * m_sampleBytes);
+    }
+
+    m_frameSize = frameSize;
+    m_chunkSize = chunkSize;
+    m_sampleRate = sampleRate;
+    reset();
+}
+
+size_t BurstReader::getChunkSize() const
+{
+    return m_chunkSize;
+}
+
+void BurstReader::reset()
+{
+    m_head = 0;
+    m_tail = 0;
+}
+
+bool BurstReader::fill()
+{
+    // Carry a trailing partial frame to the front; it precedes the new read.
+    size_t carried = m_tail - m_head;
+    std::copy(m_buffer.data() + m_head * m_sampleBytes, m_buffer.data() + m_tail * m_sampleBytes, m_buffer.data());
+    m_head = 0;
+    m_tail = carried;
+
+    void *buffs[] = {m_buffer.data() + carried * m_sampleBytes};
+    size_t request = m_chunkSize - carried;
+    int flags = 0;
+    long long time_ns = 0;
+    int ret;
+    {
+        PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Read);
+        ret = m_device.readStream(m_stream, buffs, request, flags, time_ns, READ_TIMEOUT_US);
+    }
+    m_metrics.recordRead(ret, request, flags);
+    if (ret <= 0)
+    {
+        return false;
+    }
+
+    m_samplesRead.fetch_add(static_cast<uint64_t>(ret), std::memory_order_relaxed);
+    int64_t readTimeNs = m_clock.toSystemNs(time_ns, flags, static_cast<size_t>(ret), m_sampleRate);
+    int64_t carriedNs = static_cast<int64_t>(static_cast<double>(carried) * 1e9 / m_sampleRate);
+    m_bufferTimeNs = readTimeNs - carriedNs;
+    m_bufferFlags = flags;
+    m_tail += static_cast<size_t>(ret);
+    return true;
+}
+
+bool BurstReader::next(Frame &frame)
+{
+    return next(frame, 1) == 1;
+}
+
+size_t BurstReader::next(Frame &frame, size_t maxFrames)
+{
+    while (m_tail - m_head < m_frameSize)
+    {
+        if (fill() == false)
+        {
+            return 0;
+        }
+    }
+
+    size_t frames = std::min(maxFrames, (m_tail - m_head) / m_frameSize);
+    frame.samples = m_buffer.data() + m_head * m_sampleBytes;
+    frame.size = frames * m_frameSize;
+    frame.timeNs = m_bufferTimeNs + static_cast<int64_t>(static_cast<double>(m_head) * 1e9 / m_sampleRate);
+    frame.flags = m_bufferFlags;
+    m_head += frame.size;
+    return frames;
+}
+
+size_t BurstReader::discard(size_t count)
+{
+    size_t dropped = 0;
+    while (dropped < count)
+    {
+        if (m_head == m_tail)
+        {
+            reset();
+            if (fill() == false)
+            {
+                break;
+            }
+        }
+
+        size_t n = std::min(count - dropped, m_tail - m_head);
+        m_head += n;
+        dropped += n;
+    }
+    return dropped;
+}
@@ -0,0 +1,183 @@
+#include <stdexcept>
+
+#include "Sdr/ChannelTable.hpp"
+
+using namespace Sdr;
+
+size_t ChannelTable::insert(double frequency, double bandwidth)
+{
+    size_t existing = find(frequency);
+    if (existing != NONE)
+    {
+        return existing;
+    }
+
+    size_t index;
+    if (m_free.empty() == false)
+    {
+        index = m_free.back();
+        m_free.pop_back();
+    }
+    else
+    {
+        index = m_live.size();
+        m_frequency.push_back(0.0);
+        m_bandwidth.push_back(0.0);
+        m_x0.push_back(0.0);
+        m_sigma.push_back(0.0);
+        m_lambda.push_back(0.0);
+        m_anomalyCount.push_back(0);
+        m_frames.push_back(0);
+        m_anomaly.push_back(0);
+        m_live.push_back(0);
+        m_detectors.emplace_back();
+        m_position.push_back(NONE);
+    }
+
+    m_frequency[index] = frequency;
+    m_bandwidth[index] = bandwidth;
+    m_x0[index] = 0.0;
+    m_sigma[index] = 0.0;
+    m_lambda[index] = 0.0;
+    m_anomalyCount[index] = 0;
+    m_frames[index] = 0;
+    m_anomaly[index] = 0;
+    m_live[index] = 1;
+    m_detectors[index] = std::make_unique<Detectors>();
+    m_position[index] = m_active.size();
+    m_active.push_back(index);
+    return index;
+}
+
+bool ChannelTable::remove(size_t index)
+{
+    if (contains(index) == false)
+    {
+        return false;
+    }
+
+    // Swap-remove from the dense list; only the moved slot's position changes.
+    size_t position = m_position[index];
+    size_t last = m_active.back();
+    m_active[position] = last;
+    m_position[last] = position;
+    m_active.pop_back();
+
+    m_position[index] = NONE;
+    m_live[index] = 0;
+    m_detectors[index].reset();
+    m_free.push_back(index);
+    return true;
+}
+
+size_t ChannelTable::find(double frequency) const
+{
+    for (size_t index : m_active)
+    {
+        if (m_frequency[index] == frequency)
+        {
+            return index;
+        }
+    }
+    return NONE;
+}
+
+bool ChannelTable::contains(size_t index) const
+{
+    return index < m_live.size() && m_live[index] != 0;
+}
+
+size_t ChannelTable::size() const
+{
+    return m_active.size();
+}
+
+bool ChannelTable::empty() const
+{
+    return m_active.empty();
+}
+
+const std::vector<size_t> &ChannelTable::active() const
+{
+    return m_active;
+}
+
+double ChannelTable::getFrequency(size_t index) const
+{
+    return m_frequency[index];
+}
+
+double ChannelTable::getBandwidth(size_t index) const
+{
+    return m_bandwidth[index];
+}
+
+bool ChannelTable::isAnomalous(size_t index) const
+{
+    return m_anomaly[index] != 0;
+}
+
+void ChannelTable::setAnomalous(size_t index, bool anomalous)
+{
+    if (anomalous == true && m_anomaly[index] == 0)
+    {
+        m_anomalyCount[index]++;
+    }
+    m_anomaly[index] = anomalous ? 1 : 0;
+}
+
+uint64_t ChannelTable::getAnomalyCount(size_t index) const
+{
+    return m_anomalyCount[index];
+}
+
+void ChannelTable::addFrames(size_t index, uint64_t frames)
+{
+    m_frames[index] += frames;
+}
+
+uint64_t ChannelTable::getFrameCount(size_t index) const
+{
+    return m_frames[index];
+}
+
+void ChannelTable::syncModel(size_t index)
+{
+    const Dsp::AnomalyDetection &anomDet = detectors(index).anomDet;
+    m_x0[index] = anomDet.getX0();
+    m_sigma[index] = anomDet.getSigma();
+    m_lambda[index] = anomDet.getLambda();
+}
+
+double ChannelTable::getX0(size_t index) const
+{
+    return m_x0[index];
+}
+
+double ChannelTable::getSigma(size_t index) const
+{
+    return m_sigma[index];
+}
+
+double ChannelTable::getLambda(size_t index) const
+{
+    return m_lambda[index];
+}
+
+ChannelTable::Detectors &ChannelTable::detectors(size_t index)
+{
+    if (contains(index) == false)
+    {
+        throw std::runtime_error("No channel in slot");
+    }
+    return *m_detectors[index];
+}
+
+const ChannelTable::Detectors &ChannelTable::detectors(size_t index) const
+{
+    if (contains(index) == false)
+    {
+        throw std::runtime_error("No channel in slot");
+    }
+    return *m_detectors[index];
+}
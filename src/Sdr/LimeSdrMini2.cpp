@@ -1,124 +1,557 @@
 #include <thread>
 #include <chrono>
+#include <cstdlib>
+#include <algorithm>
 
 #include <SoapySDR/Device.hpp>
 #include <SoapySDR/Formats.hpp>
 
 #include "pch.hpp"
 #include "Sdr/LimeSdrMini2.hpp"
+#include "Sdr/StreamClock.hpp"
 
 #include "Dsp/PowerSpectralDensity.hpp"
 #include "Dsp/AnomalyDetection.hpp"
+#include "Dsp/FramePool.hpp"
+#include "Dsp/Channelizer.hpp"
 
 using namespace Sdr;
 
-LimeSdrMini2::LimeSdrMini2() : SdrBase("lime"),
+LimeSdrMini2::LimeSdrMini2(size_t index) : SdrBase("lime", index),
                                m_psd(std::make_unique<Dsp::PowerSpectralDensity>()),
-                               m_anomDet(std::make_unique<Dsp::AnomalyDetection>()) {}
+                               m_anomDet(std::make_unique<Dsp::AnomalyDetection>()),
+                               m_ring(RING_BLOCK_COUNT) {}
+
+LimeSdrMini2::LimeSdrMini2(std::unique_ptr<SoapySDR::Device> device) : SdrBase("lime", std::move(device)),
+                                                                       m_psd(std::make_unique<Dsp::PowerSpectralDensity>()),
+                                                                       m_anomDet(std::make_unique<Dsp::AnomalyDetection>()),
+                                                                       m_ring(RING_BLOCK_COUNT) {}
+
+LimeSdrMini2::~LimeSdrMini2()
+{
+    // Join before the DSP state the threads use is destroyed.
+    stop();
+}
 
 void LimeSdrMini2::processThread()
 {
-    SoapySDR::Stream *rx_stream = m_device->setupStream(SOAPY_SDR_RX, SOAPY_SDR_CF32);
-    if (rx_stream == NULL)
+    SoapySDR::Stream *rx_stream = setupRxStream();
+    const size_t numElements = m_psd->getFftSize();
+
+    // Each ring block holds a chunk of whole FFT frames, read with as few
+    // readStream() calls as the driver allows.
+    size_t chunk = m_readChunk > 0 ? m_readChunk : m_device->getStreamMTU(rx_stream);
+    chunk = std::max<size_t>(1, (chunk + numElements - 1) / numElements) * numElements;
+
+    // One pooled, cache-aligned arena backs every ring block plus a scratch
+    // block the capture loop reads into when the DSP thread has fallen behind.
+    // Blocks stay in the stream's native format until the DSP widens them.
+    const size_t sampleBytes = m_sampleFormat.bytesPerSample();
+    const size_t alignment = Dsp::FramePool::ALIGNMENT;
+    const size_t blockBytes = (chunk * sampleBytes + alignment - 1) / alignment * alignment;
+    Dsp::ByteFrame arenaFrame;
+    try
+    {
+        arenaFrame = Dsp::FramePool::instance().acquire<uint8_t>(blockBytes * (m_ring.capacity() + 1));
+
+        // Plan every batch geometry before samples flow: a whole block, and
+        // the one or two frames used while warming up and calibrating.
+        // Planning on the first blocks would overrun the ring.
+        m_psd->prepareBatch(chunk / numElements);
+        m_psd->prepareBatch(1);
+        m_psd->prepareBatch(2);
+        setupChannels(chunk);
+    }
+    catch (...)
     {
-        throw std::runtime_error("Failed to set up stream");
+        m_device->closeStream(rx_stream);
+        throw;
     }
     m_device->activateStream(rx_stream, 0, 0, 0);
+    uint8_t *arena = arenaFrame.data();
+    for (size_t i = 0; i < m_ring.capacity(); i++)
+    {
+        m_ring.slot(i).samples = arena + i * blockBytes;
+        m_ring.slot(i).size = chunk;
+    }
+    uint8_t *scratch = arena + m_ring.capacity() * blockBytes;
+    StreamClock clock;
+    LOG(SOAPY_SDR_INFO, "Reading %s in chunks of %zu samples (%zu frames)", m_driver.c_str(), chunk, chunk / numElements);
+    LOG(SOAPY_SDR_INFO, "%s needs %.1f frames/s of %zu-point FFTs, transforming on %zu thread(s)",
+        m_driver.c_str(), getRequiredFrameRate(), numElements, m_psd->getThreadCount());
+
+    std::thread dsp([this, chunk]()
+                    {
+                        applyThreadConfig(ThreadRole::Dsp);
+                        dspThread(chunk);
+                    });
+
+    try
+    {
+        while (m_running.load() == true)
+        {
+            Model::IqBlock *block = m_ring.tryAcquireWrite();
+            uint8_t *target = block != nullptr ? static_cast<uint8_t *>(block->samples) : scratch;
+
+            // Short reads are topped up so the block is whole frames; the
+            // block keeps the timestamp of its first read.
+            size_t filled = 0;
+            int blockFlags = 0;
+            long long blockTimeNs = 0;
+            while (filled < chunk)
+            {
+                void *buffs[] = {target + filled * sampleBytes};
+                int flags = 0;
+                long long time_ns = 0;
+                int ret;
+                {
+                    PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Read);
+                    ret = m_device->readStream(rx_stream, buffs, chunk - filled, flags, time_ns, 1e5);
+                }
+                m_metrics.recordRead(ret, chunk - filled, flags);
+                if (ret <= 0)
+                {
+                    break;
+                }
+                if (filled == 0)
+                {
+                    blockFlags = flags;
+                    blockTimeNs = time_ns;
+                }
+                filled += static_cast<size_t>(ret);
+            }
+
+            if (block == nullptr)
+            {
+                m_metrics.add(PipelineMetrics::Counter::DroppedSamples, static_cast<uint64_t>(filled));
+                continue;
+            }
+
+            // A failed read leaves a partial frame at the end; drop it.
+            m_samplesRead.fetch_add(static_cast<uint64_t>(filled), std::memory_order_relaxed);
+            size_t size = filled / numElements * numElements;
+            if (size == 0)
+            {
+                continue;
+            }
+
+            block->size = size;
+            block->timeNs = clock.toSystemNs(blockTimeNs, blockFlags, filled, m_sampleRate);
+            block->flags = blockFlags;
+            m_ring.commitWrite();
+        }
+    }
+    catch (...)
+    {
+        LOG(SOAPY_SDR_ERROR, "Stopping %s run thread due to ERROR", m_driver.c_str());
+        m_running.store(false);
+        dsp.join();
+        throw;
+    }
+    LOG(SOAPY_SDR_INFO, "Stopping %s run thread", m_driver.c_str());
+    dsp.join();
+    m_device->deactivateStream(rx_stream, 0, 0);
+    m_device->closeStream(rx_stream);
+    LOG(SOAPY_SDR_INFO, "Deactivated and closed %s RX stream successfully (overruns: %llu, dropped samples: %llu, underruns: %llu)",
+        m_driver.c_str(),
+        static_cast<unsigned long long>(getOverrunCount()),
+        static_cast<unsigned long long>(getDroppedSampleCount()),
+        static_cast<unsigned long long>(getUnderrunCount()));
+}
+
+void LimeSdrMini2::dspThread(size_t chunkSize)
+{
     const size_t numElements = m_psd->getFftSize();
-    std::complex<float> *buff = new std::complex<float>[numElements];
-    std::complex<float> *out = new std::complex<float>[numElements];
-    float *psdReal = new float[numElements];
+    // Frames of a whole block, the batch geometry planned in processThread().
+    const size_t blockFrames = chunkSize / numElements;
+    Dsp::FramePool &pool = Dsp::FramePool::instance();
 
+    // This is the body of a bare std::thread, so allocation failures must
+    // be caught here too rather than terminate the process.
     try
     {
+        Dsp::IqFrame outFrame = pool.acquire<std::complex<float>>(chunkSize);
+        Dsp::RealFrame psdFrame = pool.acquire<float>(numElements);
+        std::complex<float> *out = outFrame.data();
+        float *psdReal = psdFrame.data();
+
         bool init = true;
         bool high = false;
+        if (m_anomDet->isReady() == false)
+        {
+            loadModel(*m_anomDet, m_frequency);
+        }
         bool previousIsAnomDetReady = m_anomDet->isReady();
         while (m_running.load() == true)
         {
-            void *buffs[] = {buff};
-            int flags;
-            long long time_ns;
-            m_device->readStream(rx_stream, buffs, numElements, flags, time_ns, 1e5);
-
-            m_psd->execute(buff, out);
+            Model::IqBlock *block = m_ring.tryAcquireRead();
+            if (block == nullptr)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            recordIq(block->samples, block->size, block->timeNs, m_frequency);
 
-            float avgPower = static_cast<float>(m_psd->computeAvgPower(out));
+            size_t averaged;
+            {
+                PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Fft);
+                averaged = m_psd->welch(block->samples, m_sampleFormat, block->size, psdReal, m_sampleRate);
+            }
 
-            if (init == true)
+            bool collect = false;
+            bool refit = false;
+            if (init == false && previousIsAnomDetReady == true)
             {
-                init = false;
-                continue;
+                collect = isTimeToCollectSample();
+                refit = isTimeToProcessSampleDistribution();
+            }
+            if (m_channelizer != nullptr)
+            {
+                processChannels(block->samples, block->size, collect, refit);
             }
 
-            bool isAnom = false;
+            // The block is a chunk of whole frames; each one is an FFT and
+            // a power sample stamped with the time of its first sample. One
+            // batched FFT covers the frames used: all of them once
+            // calibrated, else the first after the warm-up frame. While
+            // calibrating, blocks between spaced-out samples only feed the
+            // Welch PSD, so the ring keeps draining.
+            const bool warmup = init;
+            const size_t frames = block->size / numElements;
+            size_t transformed = frames;
             if (previousIsAnomDetReady == false)
             {
-                m_anomDet->pushSample(avgPower);
-                previousIsAnomDetReady = m_anomDet->isReady();
-                if (previousIsAnomDetReady == true)
+                if (warmup == true)
                 {
-                    m_anomDet->processDistribution();
-                    m_currentTimeS = std::chrono::system_clock::now();
-                    m_lastSampleCollectedS = std::chrono::system_clock::now();
-                    m_lastDistributionProcessedS = std::chrono::system_clock::now();
-                    LOG(SOAPY_SDR_INFO, "Calibrating initial distribution completed");
+                    transformed = std::min<size_t>(frames, 2);
+                }
+                else
+                {
+                    transformed = isTimeToCollectCalibrationSample() == true ? std::min<size_t>(frames, 1) : 0;
                 }
-                std::this_thread::sleep_for(std::chrono::milliseconds(20));
-                LOG(SOAPY_SDR_DEBUG, "Calibrating initial distribution...");
             }
-            else
+            const double frameNs = static_cast<double>(numElements) * 1e9 / m_sampleRate;
+            if (transformed > 0)
             {
-                isAnom = m_anomDet->isAnomaly(avgPower);
+                PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Fft);
+                if (transformed > 2 && transformed != blockFrames)
+                {
+                    // A short block after a failed read has no batch plan;
+                    // planning one here would stall the ring, so transform
+                    // it a frame at a time with the single-frame plan.
+                    const uint8_t *bytes = static_cast<const uint8_t *>(block->samples);
+                    const size_t frameBytes = numElements * m_sampleFormat.bytesPerSample();
+                    for (size_t f = 0; f < transformed; f++)
+                    {
+                        m_psd->execute(bytes + f * frameBytes, m_sampleFormat, out + f * numElements);
+                    }
+                }
+                else
+                {
+                    m_psd->executeBatch(block->samples, m_sampleFormat, transformed, out);
+                }
             }
+            m_framesProcessed.fetch_add(transformed, std::memory_order_relaxed);
 
-            if (isAnom == false)
+            for (size_t f = 0; f < transformed; f++)
             {
-                if (high == true)
+                const std::complex<float> *spectrum = out + f * numElements;
+                int64_t timeNs = block->timeNs + static_cast<int64_t>(static_cast<double>(f) * frameNs);
+
+                float avgPower;
+                {
+                    PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Power);
+                    avgPower = static_cast<float>(m_psd->computeAvgPower(spectrum));
+                }
+
+                if (init == true)
                 {
-                    high = false;
-                    LOG(SOAPY_SDR_INFO, "🔴 Anomaly Ended on LimeSdr @ %f", m_frequency);
+                    init = false;
+                    continue;
                 }
 
-                if (isTimeToCollectSample())
+                bool isAnom = false;
+                bool calibrating = previousIsAnomDetReady == false;
+                if (calibrating == true)
                 {
                     m_anomDet->pushSample(avgPower);
+                    previousIsAnomDetReady = m_anomDet->isReady();
+                    if (previousIsAnomDetReady == true)
+                    {
+                        PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Refit, false);
+                        m_anomDet->processDistribution();
+                        saveModel(*m_anomDet, m_frequency);
+                        publishDistribution(*m_anomDet);
+                        m_currentTimeS = std::chrono::system_clock::now();
+                        m_lastSampleCollectedS = std::chrono::system_clock::now();
+                        m_lastDistributionProcessedS = std::chrono::system_clock::now();
+                        LOG(SOAPY_SDR_INFO, "Calibrating initial distribution completed");
+                    }
+                    LOG(SOAPY_SDR_DEBUG, "Calibrating initial distribution...");
+                }
+                else
+                {
+                    PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Detection);
+                    if (m_anomDet->updateModel() == true)
+                    {
+                        saveModel(*m_anomDet, m_frequency);
+                        publishDistribution(*m_anomDet);
+                    }
+                    isAnom = m_anomDet->isAnomaly(avgPower);
                 }
-                if (isTimeToProcessSampleDistribution())
+
+                if (isAnom == false)
+                {
+                    if (high == true)
+                    {
+                        high = false;
+                        LOG(SOAPY_SDR_INFO, "🔴 Anomaly Ended on LimeSdr @ %f", m_frequency);
+                    }
+
+                    // The collect and refit timers fire once per block. Only
+                    // real refit work is timed, and every instance of it.
+                    if (collect == true && f == 0)
+                    {
+                        PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Refit, false);
+                        m_anomDet->pushSample(avgPower);
+                        m_anomDet->refitLocationScale();
+                    }
+                    if (refit == true && f == 0)
+                    {
+                        PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Refit, false);
+                        m_anomDet->requestRefit();
+                    }
+                }
+                else
                 {
-                    m_anomDet->processDistribution();
+                    if (high == false)
+                    {
+                        high = true;
+                        LOG(SOAPY_SDR_INFO, "🔵 Anomaly Detected on LimeSdr @ %f", m_frequency);
+                        triggerRecording();
+                    }
+                }
+
+                {
+                    PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Output);
+                    publishAvgPower(avgPower, timeNs);
+                }
+
+                // Calibration samples are spaced in time, so one per block.
+                if (calibrating == true)
+                {
+                    break;
                 }
             }
-            else
+            // The slot is the capture thread's again once committed.
+            const int64_t blockTimeNs = block->timeNs;
+            m_ring.commitRead();
+
+            if (warmup == false && averaged > 0)
             {
-                if (high == false)
                 {
-                    high = true;
-                    LOG(SOAPY_SDR_INFO, "🔵 Anomaly Detected on LimeSdr @ %f", m_frequency);
+                    PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Detection);
+                    m_binDet.process(psdReal, numElements);
                 }
+                PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Output);
+                publishPsd(psdReal, numElements, blockTimeNs);
+                logBinAnomalies(m_binDet, m_frequency);
             }
-
-            float avgPowerList[] = {avgPower};
-            m_psd->toFile("avg_power_output.txt", m_frequency, m_bandwidth, avgPowerList, 1);
-            m_psd->computeRealPsd(out, psdReal, m_sampleRate);
-            m_psd->toFile("psd_output.txt", m_frequency, m_bandwidth, psdReal, numElements);
         }
     }
     catch (...)
     {
-        LOG(SOAPY_SDR_ERROR, "Stopping %s run thread due to ERROR", m_driver.c_str());
-        delete[] buff;
-        delete[] out;
-        delete[] psdReal;
-        throw;
+        LOG(SOAPY_SDR_ERROR, "Stopping %s DSP thread due to ERROR", m_driver.c_str());
+        m_running.store(false);
     }
-    LOG(SOAPY_SDR_INFO, "Stopping %s run thread", m_driver.c_str());
-    delete[] buff;
-    delete[] out;
-    delete[] psdReal;
-    m_device->deactivateStream(rx_stream, 0, 0);
-    m_device->closeStream(rx_stream);
-    LOG(SOAPY_SDR_INFO, "Deactivated and closed %s RX stream successfully", m_driver.c_str());
+    LOG(SOAPY_SDR_INFO, "Stopping %s DSP thread", m_driver.c_str());
+}
+
+void LimeSdrMini2::setupChannels(size_t blockSize)
+{
+    m_channels.clear();
+    m_channelizer.reset();
+    if (m_channelCount < 2)
+    {
+        return;
+    }
+
+    // Narrower channels would get an FFT too small to average and bin.
+    const size_t maxCount = static_cast<size_t>(m_sampleRate / MIN_CHANNEL_RATE_HZ);
+    if (m_channelCount > maxCount)
+    {
+        LOG(SOAPY_SDR_WARNING, "%s cannot split %f Hz into %zu channels; using %zu",
+            m_driver.c_str(), m_sampleRate, m_channelCount, maxCount);
+        m_channelCount = maxCount;
+        if (m_channelCount < 2)
+        {
+            return;
+        }
+    }
+
+    m_channelizer = std::make_unique<Dsp::Channelizer>(m_channelCount);
+    const double channelRate = m_sampleRate / static_cast<double>(m_channelCount);
+    m_channels.resize(m_channelCount);
+    m_channelDet.reset(m_channelCount);
+    for (size_t k = 0; k < m_channelCount; k++)
+    {
+        Model::SdrRoundRobinConfig &channel = m_channels[k];
+        channel.anomaly = false;
+        channel.frequency = m_frequency + Dsp::Channelizer::channelOffset(k, m_channelCount, m_sampleRate);
+        channel.bandwidth = channelRate;
+        channel.psd.setFftSize(channelRate);
+        channel.psd.setWelch(WELCH_AVERAGE_COUNT, WELCH_OVERLAP);
+        if (loadModel(channel.anomDet, channel.frequency) == true)
+        {
+            m_channelDet.setModel(k, channel.anomDet);
+        }
+    }
+
+    // A block of blockSize samples plus a partial block carried over from
+    // the previous call yields at most blockSize / M + 1 outputs per channel.
+    Dsp::FramePool &pool = Dsp::FramePool::instance();
+    m_channelStride = blockSize / m_channelCount + 1;
+    m_channelOut = pool.acquire<std::complex<float>>(m_channelStride * m_channelCount);
+    m_channelPsd = pool.acquire<float>(m_channels.front().psd.getFftSize());
+    m_channelPower = pool.acquire<float>(m_channelCount);
+    LOG(SOAPY_SDR_INFO, "Channelizing %s into %zu channels of %f Hz", m_driver.c_str(), m_channelCount, channelRate);
+}
+
+void LimeSdrMini2::processChannels(const void *samples, size_t count, bool collect, bool refit)
+{
+    size_t produced;
+    {
+        PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Fft);
+        produced = m_channelizer->process(samples, m_sampleFormat, count, m_channelOut.data(), m_channelStride);
+    }
+    if (produced == 0)
+    {
+        return;
+    }
+
+    // Welch, power and bins per channel first; the detectors of every
+    // calibrated channel then run as one batch over m_channelPower.
+    const float channelRate = static_cast<float>(m_sampleRate / static_cast<double>(m_channelCount));
+    float *power = m_channelPower.data();
+    for (size_t k = 0; k < m_channelCount; k++)
+    {
+        Model::SdrRoundRobinConfig &channel = m_channels[k];
+        const std::complex<float> *stream = m_channelOut.data() + k * m_channelStride;
+
+        size_t averaged;
+        {
+            PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Fft);
+            averaged = channel.psd.welch(stream, produced, m_channelPsd.data(), channelRate);
+        }
+
+        {
+            PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Power);
+            power[k] = static_cast<float>(Dsp::PowerSpectralDensity::computeAvgPower(stream, produced));
+        }
+
+        if (channel.anomDet.isReady() == false)
+        {
+            continue;
+        }
+
+        {
+            PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Detection);
+            if (channel.anomDet.updateModel() == true)
+            {
+                m_channelDet.setModel(k, channel.anomDet);
+                saveModel(channel.anomDet, channel.frequency);
+            }
+            if (averaged > 0)
+            {
+                channel.binDet.process(m_channelPsd.data(), channel.psd.getFftSize());
+            }
+        }
+
+        if (averaged > 0)
+        {
+            logBinAnomalies(channel.binDet, channel.frequency, channelRate);
+        }
+    }
+
+    {
+        PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Detection);
+        m_channelDet.process(power, m_channelCount);
+    }
+
+    for (size_t k = 0; k < m_channelCount; k++)
+    {
+        Model::SdrRoundRobinConfig &channel = m_channels[k];
+        const float avgPower = power[k];
+
+        // Not armed in the batch yet, so its mask bit is clear.
+        if (channel.anomDet.isReady() == false)
+        {
+            channel.anomDet.pushSample(avgPower);
+            if (channel.anomDet.isReady() == true)
+            {
+                PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Refit, false);
+                channel.anomDet.processDistribution();
+                m_channelDet.setModel(k, channel.anomDet);
+                saveModel(channel.anomDet, channel.frequency);
+                LOG(SOAPY_SDR_INFO, "Calibrating initial distribution completed for channel %zu @ %f Hz", k, channel.frequency);
+            }
+            continue;
+        }
+
+        if (m_channelDet.isAnomaly(k) == false)
+        {
+            if (channel.anomaly == true)
+            {
+                channel.anomaly = false;
+                LOG(SOAPY_SDR_INFO, "🔴 Anomaly Ended on LimeSdr channel %zu @ %f", k, channel.frequency);
+            }
+
+            if (collect == true)
+            {
+                PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Refit, false);
+                channel.anomDet.pushSample(avgPower);
+                channel.anomDet.refitLocationScale();
+                m_channelDet.setModel(k, channel.anomDet);
+            }
+            if (refit == true)
+            {
+                PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Refit, false);
+                channel.anomDet.requestRefit();
+            }
+        }
+        else if (channel.anomaly == false)
+        {
+            channel.anomaly = true;
+            LOG(SOAPY_SDR_INFO, "🔵 Anomaly Detected on LimeSdr channel %zu @ %f", k, channel.frequency);
+            triggerRecording();
+        }
+    }
+}
+
+void LimeSdrMini2::setChannelCount(size_t count)
+{
+    m_channelCount = count;
+}
+
+size_t LimeSdrMini2::getChannelCount() const
+{
+    return m_channelCount;
+}
+
+void LimeSdrMini2::setFftThreads(size_t threads)
+{
+    m_psd->setThreadCount(threads);
+}
+
+size_t LimeSdrMini2::getFftThreads() const
+{
+    return m_psd->getThreadCount();
+}
+
+double LimeSdrMini2::getRequiredFrameRate() const
+{
+    size_t numElements = m_psd->getFftSize();
+    return numElements > 0 && m_sampleRate > 0 ? m_sampleRate / static_cast<double>(numElements) : 0.0;
 }
 
 void LimeSdrMini2::configure(double frequency,
@@ -128,4 +561,20 @@ void LimeSdrMini2::configure(double frequency,
 {
     SdrBase::configure(frequency, bandwidth, gain, sampleRate);
     m_psd->setFftSize(bandwidth);
+    m_psd->setWelch(WELCH_AVERAGE_COUNT, WELCH_OVERLAP);
+}
+
+uint64_t LimeSdrMini2::getOverrunCount() const
+{
+    return m_ring.overrunCount();
+}
+
+uint64_t LimeSdrMini2::getUnderrunCount() const
+{
+    return m_ring.underrunCount();
+}
+
+uint64_t LimeSdrMini2::getDroppedSampleCount() const
+{
+    return m_metrics.get(PipelineMetrics::Counter::DroppedSamples);
 }
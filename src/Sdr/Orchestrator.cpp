@@ -0,0 +1,175 @@
+#include <set>
+#include <cctype>
+#include <cstdio>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+
+#include "pch.hpp"
+#include "Sdr/Orchestrator.hpp"
+
+using namespace Sdr;
+
+Orchestrator::~Orchestrator()
+{
+    stop();
+}
+
+SdrBase &Orchestrator::add(std::unique_ptr<SdrBase> device, const SdrBase::ThreadConfig &config)
+{
+    if (device == nullptr)
+    {
+        throw std::runtime_error("Cannot add a null device");
+    }
+
+    device->setThreadConfig(config);
+    m_entries.push_back(Entry{std::move(device), SdrBase::Stats{0, 0}});
+    return *m_entries.back().device;
+}
+
+void Orchestrator::assignOutputPrefixes()
+{
+    std::set<std::string> taken;
+    for (auto &entry : m_entries)
+    {
+        SdrBase &device = *entry.device;
+        if (taken.count(device.getOutputPrefix()) == 0)
+        {
+            taken.insert(device.getOutputPrefix());
+            continue;
+        }
+
+        // Rings of different sizes sharing a file would truncate it under
+        // each other's mappings.
+        std::string base = device.getOutputPrefix() + device.getDeviceId();
+        for (auto &c : base)
+        {
+            if (std::isalnum(static_cast<unsigned char>(c)) == 0)
+            {
+                c = '_';
+            }
+        }
+        std::string prefix = base + "_";
+        for (size_t n = 2; taken.count(prefix) > 0; n++)
+        {
+            prefix = base + "_" + std::to_string(n) + "_";
+        }
+        LOG(SOAPY_SDR_WARNING, "%s output prefix \"%s\" is already in use; using \"%s\"",
+            device.getDriver().c_str(), device.getOutputPrefix().c_str(), prefix.c_str());
+        device.setOutputPrefix(prefix);
+        taken.insert(prefix);
+    }
+}
+
+void Orchestrator::start()
+{
+    assignOutputPrefixes();
+    for (auto &entry : m_entries)
+    {
+        entry.lastStats = entry.device->getStats();
+        entry.device->run();
+    }
+    m_lastReport = std::chrono::steady_clock::now();
+}
+
+void Orchestrator::stop()
+{
+    // Signal every device before joining any, so they wind down together.
+    for (auto &entry : m_entries)
+    {
+        entry.device->requestStop();
+    }
+    for (auto &entry : m_entries)
+    {
+        entry.device->stop();
+    }
+}
+
+size_t Orchestrator::size() const
+{
+    return m_entries.size();
+}
+
+std::vector<Orchestrator::DeviceReport> Orchestrator::report()
+{
+    auto now = std::chrono::steady_clock::now();
+    double elapsedS = std::chrono::duration<double>(now - m_lastReport).count();
+    m_lastReport = now;
+
+    std::vector<DeviceReport> reports;
+    reports.reserve(m_entries.size());
+    for (auto &entry : m_entries)
+    {
+        SdrBase::Stats stats = entry.device->getStats();
+        double samples = static_cast<double>(stats.samplesRead - entry.lastStats.samplesRead);
+        double frames = static_cast<double>(stats.framesProcessed - entry.lastStats.framesProcessed);
+        entry.lastStats = stats;
+
+        reports.push_back(DeviceReport{entry.device->getDriver(),
+                                       entry.device->isRunning(),
+                                       stats.samplesRead,
+                                       stats.framesProcessed,
+                                       elapsedS > 0 ? samples / elapsedS : 0.0,
+                                       elapsedS > 0 ? frames / elapsedS : 0.0,
+                                       entry.device->getRequiredFrameRate()});
+    }
+    return reports;
+}
+
+void Orchestrator::dumpMetrics(const char *fileName) const
+{
+    std::string json = "{\"devices\": [";
+    for (size_t i = 0; i < m_entries.size(); i++)
+    {
+        const SdrBase &device = *m_entries[i].device;
+        SdrBase::Stats stats = device.getStats();
+
+        char line[320];
+        std::snprintf(line, sizeof(line), "%s{\"driver\": \"%s\", \"running\": %s, \"samples_read\": %llu, \"frames_processed\": %llu, \"required_frames_per_second\": %.1f, \"metrics\": ",
+                      i == 0 ? "" : ", ",
+                      device.getDriver().c_str(),
+                      device.isRunning() ? "true" : "false",
+                      static_cast<unsigned long long>(stats.samplesRead),
+                      static_cast<unsigned long long>(stats.framesProcessed),
+                      device.getRequiredFrameRate());
+        json += line;
+        PipelineMetrics::toJson(json, device.getMetrics());
+        json += "}";
+    }
+    json += "]}\n";
+
+    std::string tempFile = std::string(fileName) + ".tmp";
+    std::ofstream os(tempFile, std::ios::trunc);
+    if (os.is_open())
+    {
+        os << json;
+        os.flush();
+        os.close();
+
+        std::rename(tempFile.c_str(), fileName);
+    }
+}
+
+void Orchestrator::logReport()
+{
+    for (const auto &r : report())
+    {
+        // Devices that must transform every frame report against that rate.
+        char required[64] = "";
+        if (r.requiredFramesPerSecond > 0)
+        {
+            std::snprintf(required, sizeof(required), " of %.1f required (%.0f%%)",
+                          r.requiredFramesPerSecond,
+                          100.0 * r.framesPerSecond / r.requiredFramesPerSecond);
+        }
+
+        LOG(SOAPY_SDR_INFO, "%s: %s, %.3f MS/s, %.1f frames/s%s (%llu samples, %llu frames)",
+            r.driver.c_str(),
+            r.running ? "running" : "stopped",
+            r.samplesPerSecond / 1e6,
+            r.framesPerSecond,
+            required,
+            static_cast<unsigned long long>(r.samplesRead),
+            static_cast<unsigned long long>(r.framesProcessed));
+    }
+}
@@ -0,0 +1,162 @@
+#include <cstdio>
+
+#include <SoapySDR/Errors.h>
+#include <SoapySDR/Constants.h>
+
+#include "Sdr/PipelineMetrics.hpp"
+
+using namespace Sdr;
+
+PipelineMetrics::ScopedTimer::ScopedTimer(PipelineMetrics &metrics, Stage stage, bool sampled) : m_metrics(metrics),
+                                                                                                 m_stage(stage),
+                                                                                                 m_enabled(sampled == false || metrics.sample(stage))
+{
+    if (m_enabled == true)
+    {
+        m_start = std::chrono::steady_clock::now();
+    }
+}
+
+PipelineMetrics::ScopedTimer::~ScopedTimer()
+{
+    if (m_enabled == false)
+    {
+        return;
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - m_start;
+    m_metrics.record(m_stage, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
+
+void PipelineMetrics::record(Stage stage, uint64_t nanoseconds)
+{
+    m_stages[static_cast<size_t>(stage)].record(nanoseconds);
+}
+
+bool PipelineMetrics::sample(Stage stage)
+{
+    std::atomic<uint32_t> &tick = m_ticks[static_cast<size_t>(stage)];
+    uint32_t t = tick.load(std::memory_order_relaxed);
+    tick.store(t + 1, std::memory_order_relaxed);
+    return t % TIMING_SAMPLE_PERIOD == 0;
+}
+
+void PipelineMetrics::add(Counter counter, uint64_t value)
+{
+    m_counters[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t PipelineMetrics::get(Counter counter) const
+{
+    return m_counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+}
+
+void PipelineMetrics::recordRead(int ret, size_t requested, int flags)
+{
+    if (ret == SOAPY_SDR_OVERFLOW || (ret >= 0 && (flags & SOAPY_SDR_END_ABRUPT) != 0))
+    {
+        add(Counter::Overflows);
+    }
+    else if (ret == SOAPY_SDR_TIMEOUT)
+    {
+        add(Counter::Timeouts);
+    }
+    else if (ret < 0)
+    {
+        add(Counter::StreamErrors);
+    }
+
+    if (ret >= 0 && static_cast<size_t>(ret) < requested)
+    {
+        add(Counter::ShortReads);
+    }
+}
+
+PipelineMetrics::Snapshot PipelineMetrics::snapshot() const
+{
+    Snapshot s;
+    for (size_t i = 0; i < STAGE_COUNT; i++)
+    {
+        Ds::LatencyHistogram::Snapshot h = m_stages[i].snapshot();
+        s.stages[i] = StageSnapshot{h.count, h.mean(), h.quantile(0.5), h.quantile(0.99), h.quantile(0.999), h.max};
+    }
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+        s.counters[i] = m_counters[i].load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+const char *PipelineMetrics::stageName(Stage stage)
+{
+    switch (stage)
+    {
+    case Stage::Read:
+        return "read";
+    case Stage::Fft:
+        return "fft";
+    case Stage::Power:
+        return "power";
+    case Stage::Detection:
+        return "detection";
+    case Stage::Refit:
+        return "refit";
+    case Stage::Output:
+        return "output";
+    }
+    return "unknown";
+}
+
+const char *PipelineMetrics::counterName(Counter counter)
+{
+    switch (counter)
+    {
+    case Counter::Overflows:
+        return "overflows";
+    case Counter::Timeouts:
+        return "timeouts";
+    case Counter::StreamErrors:
+        return "stream_errors";
+    case Counter::ShortReads:
+        return "short_reads";
+    case Counter::DroppedSamples:
+        return "dropped_samples";
+    case Counter::Retunes:
+        return "retunes";
+    case Counter::SettleSamples:
+        return "settle_samples";
+    }
+    return "unknown";
+}
+
+void PipelineMetrics::toJson(std::string &out, const Snapshot &snapshot)
+{
+    char line[256];
+
+    out += "{\"stages\": {";
+    for (size_t i = 0; i < STAGE_COUNT; i++)
+    {
+        const StageSnapshot &s = snapshot.stages[i];
+        std::snprintf(line, sizeof(line),
+                      "%s\"%s\": {\"count\": %llu, \"mean_ns\": %.1f, \"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu}",
+                      i == 0 ? "" : ", ",
+                      stageName(static_cast<Stage>(i)),
+                      static_cast<unsigned long long>(s.count),
+                      s.meanNs,
+                      static_cast<unsigned long long>(s.p50Ns),
+                      static_cast<unsigned long long>(s.p99Ns),
+                      static_cast<unsigned long long>(s.p999Ns),
+                      static_cast<unsigned long long>(s.maxNs));
+        out += line;
+    }
+    out += "}, \"counters\": {";
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+    {
+        std::snprintf(line, sizeof(line), "%s\"%s\": %llu",
+                      i == 0 ? "" : ", ",
+                      counterName(static_cast<Counter>(i)),
+                      static_cast<unsigned long long>(snapshot.counters[i]));
+        out += line;
+    }
+    out += "}}";
+}
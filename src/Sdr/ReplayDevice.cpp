@@ -0,0 +1,447 @@
+#include <math.h>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <SoapySDR/Formats.hpp>
+
+#include "Sdr/ReplayDevice.hpp"
+
+using namespace Sdr;
+
+namespace
+{
+    struct ReplayStream
+    {
+        std::string format;
+    };
+
+    size_t sampleBytes(const std::string &format)
+    {
+        if (format == SOAPY_SDR_CF32)
+        {
+            return 2 * sizeof(float);
+        }
+        if (format == SOAPY_SDR_CS16)
+        {
+            return 2 * sizeof(int16_t);
+        }
+        if (format == SOAPY_SDR_CS8)
+        {
+            return 2 * sizeof(int8_t);
+        }
+        if (format == SOAPY_SDR_CU8)
+        {
+            return 2 * sizeof(uint8_t);
+        }
+        throw std::runtime_error("Unsupported replay format " + format);
+    }
+
+    // Matches the decoding in readFile(), so encoding what it decoded
+    // reproduces the file.
+    double fullScale(const std::string &format)
+    {
+        if (format == SOAPY_SDR_CS16)
+        {
+            return 32768.0;
+        }
+        if (format == SOAPY_SDR_CS8)
+        {
+            return 128.0;
+        }
+        if (format == SOAPY_SDR_CU8)
+        {
+            return 127.5;
+        }
+        return 1.0;
+    }
+
+    template <typename T>
+    T quantise(float value, float scale, float offset, long low, long high)
+    {
+        return static_cast<T>(std::clamp(lroundf(value * scale + offset), low, high));
+    }
+
+    void encode(const std::complex<float> *in, size_t count, const std::string &format, void *out)
+    {
+        const float scale = static_cast<float>(fullScale(format));
+        if (format == SOAPY_SDR_CS16)
+        {
+            int16_t *iq = static_cast<int16_t *>(out);
+            for (size_t i = 0; i < count; i++)
+            {
+                iq[2 * i] = quantise<int16_t>(in[i].real(), scale, 0.0f, -32768, 32767);
+                iq[2 * i + 1] = quantise<int16_t>(in[i].imag(), scale, 0.0f, -32768, 32767);
+            }
+        }
+        else if (format == SOAPY_SDR_CS8)
+        {
+            int8_t *iq = static_cast<int8_t *>(out);
+            for (size_t i = 0; i < count; i++)
+            {
+                iq[2 * i] = quantise<int8_t>(in[i].real(), scale, 0.0f, -128, 127);
+                iq[2 * i + 1] = quantise<int8_t>(in[i].imag(), scale, 0.0f, -128, 127);
+            }
+        }
+        else
+        {
+            uint8_t *iq = static_cast<uint8_t *>(out);
+            for (size_t i = 0; i < count; i++)
+            {
+                iq[2 * i] = quantise<uint8_t>(in[i].real(), scale, scale, 0, 255);
+                iq[2 * i + 1] = quantise<uint8_t>(in[i].imag(), scale, scale, 0, 255);
+            }
+        }
+    }
+}
+
+ReplayDevice::ReplayDevice(const Config &config) : m_config(config),
+                                                   m_noiseSeed(config.seed == 0 ? 1 : config.seed)
+{
+    m_sampleBytes = sampleBytes(m_config.format);
+    if (m_config.source == Source::File)
+    {
+
+        int fd = open(m_config.path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Failed to open replay file " + m_config.path);
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(m_sampleBytes))
+        {
+            close(fd);
+            throw std::runtime_error("Replay file " + m_config.path + " is empty");
+        }
+
+        m_fileBytes = static_cast<size_t>(st.st_size);
+        void *map = mmap(nullptr, m_fileBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED)
+        {
+            throw std::runtime_error("Failed to map replay file " + m_config.path);
+        }
+        madvise(map, m_fileBytes, MADV_SEQUENTIAL);
+
+        m_file = static_cast<const uint8_t *>(map);
+        m_fileSamples = m_fileBytes / m_sampleBytes;
+        return;
+    }
+
+    // Cycling through a precomputed table from a random offset per read is
+    // far cheaper than drawing Gaussians per sample, and frames still differ.
+    std::mt19937 rng(m_noiseSeed);
+    std::normal_distribution<float> normal(0.0f, m_config.noiseAmplitude / sqrtf(2.0f));
+    m_noise.resize(NOISE_TABLE_SIZE);
+    for (auto &n : m_noise)
+    {
+        n = std::complex<float>(normal(rng), normal(rng));
+    }
+}
+
+ReplayDevice::~ReplayDevice()
+{
+    if (m_file != nullptr)
+    {
+        munmap(const_cast<uint8_t *>(m_file), m_fileBytes);
+    }
+}
+
+std::string ReplayDevice::getDriverKey() const
+{
+    return "replay";
+}
+
+std::string ReplayDevice::getHardwareKey() const
+{
+    return m_config.source == Source::File ? m_config.path : "synthetic";
+}
+
+std::vector<std::string> ReplayDevice::getStreamFormats(const int, const size_t) const
+{
+    return {SOAPY_SDR_CF32, SOAPY_SDR_CS16, SOAPY_SDR_CS8, SOAPY_SDR_CU8};
+}
+
+std::string ReplayDevice::getNativeStreamFormat(const int, const size_t, double &scale) const
+{
+    scale = fullScale(m_config.format);
+    return m_config.format;
+}
+
+SoapySDR::Stream *ReplayDevice::setupStream(const int direction,
+                                            const std::string &format,
+                                            const std::vector<size_t> &,
+                                            const SoapySDR::Kwargs &)
+{
+    if (direction != SOAPY_SDR_RX)
+    {
+        throw std::runtime_error("Replay device only supports RX streams");
+    }
+    sampleBytes(format);
+
+    return reinterpret_cast<SoapySDR::Stream *>(new ReplayStream{format});
+}
+
+void ReplayDevice::closeStream(SoapySDR::Stream *stream)
+{
+    delete reinterpret_cast<ReplayStream *>(stream);
+}
+
+size_t ReplayDevice::getStreamMTU(SoapySDR::Stream *) const
+{
+    return STREAM_MTU;
+}
+
+int ReplayDevice::activateStream(SoapySDR::Stream *, const int, const long long, const size_t)
+{
+    m_active = true;
+    m_sampleCount = 0;
+    m_streamStart = std::chrono::steady_clock::now();
+    return 0;
+}
+
+int ReplayDevice::deactivateStream(SoapySDR::Stream *, const int, const long long)
+{
+    m_active = false;
+    return 0;
+}
+
+int ReplayDevice::readStream(SoapySDR::Stream *stream,
+                             void *const *buffs,
+                             const size_t numElems,
+                             int &flags,
+                             long long &timeNs,
+                             const long timeoutUs)
+{
+    if (m_active == false)
+    {
+        return SOAPY_SDR_STREAM_ERROR;
+    }
+
+    // Integer streams are synthesised as CF32 and quantised on the way out.
+    const std::string &format = reinterpret_cast<ReplayStream *>(stream)->format;
+    std::complex<float> *out = static_cast<std::complex<float> *>(buffs[0]);
+    if (format != SOAPY_SDR_CF32)
+    {
+        m_encodeBuffer.resize(std::max(m_encodeBuffer.size(), numElems));
+        out = m_encodeBuffer.data();
+    }
+
+    size_t count = 0;
+    if (m_config.source == Source::File)
+    {
+        count = readFile(out, numElems);
+        if (count == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(timeoutUs));
+            return SOAPY_SDR_TIMEOUT;
+        }
+    }
+    else
+    {
+        count = numElems;
+        synthesise(out, count);
+    }
+
+    float amplitude = static_cast<float>(pow(10.0, m_gain / 20.0));
+    if (amplitude != 1.0f)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            out[i] *= amplitude;
+        }
+    }
+    if (format != SOAPY_SDR_CF32)
+    {
+        encode(out, count, format, buffs[0]);
+    }
+
+    flags = SOAPY_SDR_HAS_TIME;
+    timeNs = static_cast<long long>(m_sampleCount * 1e9 / m_sampleRate);
+    m_sampleCount += count;
+
+    pace();
+    return static_cast<int>(count);
+}
+
+size_t ReplayDevice::readFile(std::complex<float> *out, size_t count)
+{
+    if (m_fileOffset == m_fileSamples)
+    {
+        if (m_config.loop == false)
+        {
+            return 0;
+        }
+        m_fileOffset = 0;
+    }
+
+    count = std::min(count, m_fileSamples - m_fileOffset);
+    const uint8_t *in = m_file + m_fileOffset * m_sampleBytes;
+    if (m_config.format == SOAPY_SDR_CF32)
+    {
+        std::copy_n(reinterpret_cast<const std::complex<float> *>(in), count, out);
+    }
+    else if (m_config.format == SOAPY_SDR_CS16)
+    {
+        const int16_t *iq = reinterpret_cast<const int16_t *>(in);
+        for (size_t i = 0; i < count; i++)
+        {
+            out[i] = std::complex<float>(iq[2 * i] / 32768.0f, iq[2 * i + 1] / 32768.0f);
+        }
+    }
+    else if (m_config.format == SOAPY_SDR_CS8)
+    {
+        const int8_t *iq = reinterpret_cast<const int8_t *>(in);
+        for (size_t i = 0; i < count; i++)
+        {
+            out[i] = std::complex<float>(iq[2 * i] / 128.0f, iq[2 * i + 1] / 128.0f);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            out[i] = std::complex<float>((in[2 * i] - 127.5f) / 127.5f, (in[2 * i + 1] - 127.5f) / 127.5f);
+        }
+    }
+
+    m_fileOffset += count;
+    return count;
+}
+
+void ReplayDevice::synthesise(std::complex<float> *out, size_t count)
+{
+    // xorshift32 picks where in the noise table this read starts.
+    m_noiseSeed ^= m_noiseSeed << 13;
+    m_noiseSeed ^= m_noiseSeed >> 17;
+    m_noiseSeed ^= m_noiseSeed << 5;
+    size_t index = m_noiseSeed % NOISE_TABLE_SIZE;
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = m_noise[index];
+        index = index + 1 == NOISE_TABLE_SIZE ? 0 : index + 1;
+    }
+
+    if (m_config.source == Source::Noise)
+    {
+        return;
+    }
+
+    const double step = 2.0 * M_PI * (m_config.toneFrequency - m_frequency) / m_sampleRate;
+    const std::complex<double> rotation = std::polar(1.0, step);
+    const uint64_t period = std::max<uint64_t>(1, static_cast<uint64_t>(m_config.burstPeriodS * m_sampleRate));
+    const uint64_t duration = static_cast<uint64_t>(m_config.burstDurationS * m_sampleRate);
+    const bool burst = m_config.source == Source::Burst;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (burst == false || (m_sampleCount + i) % period < duration)
+        {
+            out[i] += std::complex<float>(m_config.toneAmplitude * static_cast<float>(m_phasor.real()),
+                                          m_config.toneAmplitude * static_cast<float>(m_phasor.imag()));
+        }
+        m_phasor *= rotation;
+    }
+    // Renormalise so rounding in the recurrence does not drift the amplitude.
+    m_phasor /= std::abs(m_phasor);
+}
+
+void ReplayDevice::pace()
+{
+    if (m_config.speed <= 0)
+    {
+        return;
+    }
+
+    auto due = m_streamStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                   std::chrono::duration<double>(m_sampleCount / (m_sampleRate * m_config.speed)));
+    std::this_thread::sleep_until(due);
+}
+
+void ReplayDevice::setGain(const int, const size_t, const double value)
+{
+    m_gain = value;
+}
+
+double ReplayDevice::getGain(const int, const size_t) const
+{
+    return m_gain;
+}
+
+void ReplayDevice::setFrequency(const int, const size_t, const double frequency, const SoapySDR::Kwargs &)
+{
+    if (frequency == m_frequency)
+    {
+        return;
+    }
+    m_frequency = frequency;
+
+    if (m_config.retuneLatency.count() <= 0)
+    {
+        return;
+    }
+
+    std::this_thread::sleep_for(m_config.retuneLatency);
+
+    // A running stream keeps sampling while the PLL relocks; those samples
+    // are lost, so the timestamps of the next read jump accordingly.
+    if (m_active == true)
+    {
+        uint64_t dropped = static_cast<uint64_t>(std::chrono::duration<double>(m_config.retuneLatency).count() * m_sampleRate);
+        m_sampleCount += dropped;
+        m_retuneDropped += dropped;
+    }
+}
+
+double ReplayDevice::getFrequency(const int, const size_t) const
+{
+    return m_frequency;
+}
+
+void ReplayDevice::setSampleRate(const int, const size_t, const double rate)
+{
+    if (rate <= 0)
+    {
+        throw std::runtime_error("Replay sample rate must be positive");
+    }
+    if (rate == m_sampleRate)
+    {
+        return;
+    }
+
+    // Rebase the pacing clock so earlier samples keep their timing.
+    if (m_active == true)
+    {
+        m_streamStart = std::chrono::steady_clock::now() -
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(m_sampleCount / (rate * std::max(m_config.speed, 1e-9))));
+    }
+    m_sampleRate = rate;
+}
+
+double ReplayDevice::getSampleRate(const int, const size_t) const
+{
+    return m_sampleRate;
+}
+
+void ReplayDevice::setBandwidth(const int, const size_t, const double bw)
+{
+    m_bandwidth = bw;
+}
+
+double ReplayDevice::getBandwidth(const int, const size_t) const
+{
+    return m_bandwidth;
+}
+
+uint64_t ReplayDevice::getRetuneDroppedSamples() const
+{
+    return m_retuneDropped;
+}
@@ -1,192 +1,391 @@
 #include <thread>
 #include <chrono>
+#include <algorithm>
 
 #include <SoapySDR/Device.hpp>
 #include <SoapySDR/Formats.hpp>
 
 #include "pch.hpp"
 #include "Sdr/RtlSdrV4.hpp"
-#include "DataStructure/Node.hpp"
-#include "Model/SdrRoundRobinConfig.hpp"
-#include "DataStructure/CircularLinkedList.hpp"
+#include "Dsp/FramePool.hpp"
 
 using namespace Sdr;
 
-RtlSdrV4::RtlSdrV4() : SdrBase("rtlsdr") {}
+RtlSdrV4::RtlSdrV4(size_t index) : SdrBase("rtlsdr", index) {}
 
-void RtlSdrV4::processThread()
+RtlSdrV4::RtlSdrV4(std::unique_ptr<SoapySDR::Device> device) : SdrBase("rtlsdr", std::move(device)) {}
+
+RtlSdrV4::~RtlSdrV4()
 {
-    if (m_configList.empty())
-    {
-        LOG(SOAPY_SDR_INFO, "RTL-SDR v4 process thread empty. Exiting...");
-        return;
-    }
+    // Join before the channel table the thread walks is destroyed.
+    stop();
+}
 
-    SoapySDR::Stream *rx_stream = m_device->setupStream(SOAPY_SDR_RX, SOAPY_SDR_CF32);
-    if (rx_stream == NULL)
-    {
-        throw std::runtime_error("Failed to set up stream");
-    }
+void RtlSdrV4::processThread()
+{
+    SoapySDR::Stream *rx_stream = setupRxStream();
     m_device->activateStream(rx_stream, 0, 0, 0);
 
-    auto it = m_configList.current();
-    auto *config = &it->value;
-    configure(config->frequency, BANDWIDTH_HZ, GAIN_DBI);
-
-    auto *psd = &config->psd;
-    auto *anomDet = &config->anomDet;
-    auto *anom = &config->anomaly;
+    m_current = ChannelTable::NONE;
+    double frequency = 0.0;
+    ChannelTable::Detectors *channel = nullptr;
+    Dsp::PowerSpectralDensity *psd = nullptr;
+    Dsp::AnomalyDetection *anomDet = nullptr;
+    Dsp::SpectralAnomalyDetection *binDet = nullptr;
 
-    size_t numElements = psd->getFftSize();
-    float *psdReal = new float[numElements];
-    std::complex<float> *out = new std::complex<float>[numElements];
-    std::complex<float> *buff = new std::complex<float>[numElements];
+    size_t numElements = 0;
+    Dsp::FramePool &pool = Dsp::FramePool::instance();
+    Dsp::RealFrame psdFrame;
+    Dsp::IqFrame outFrame;
+    float *psdReal = nullptr;
+    std::complex<float> *out = nullptr;
+    BurstReader reader(*m_device, rx_stream, m_sampleFormat, m_metrics, m_samplesRead);
+    BurstReader::Frame frame;
 
     try
     {
+        bool idle = false;
         while (m_running.load() == true)
         {
-            if (anomDet->isReady() == false)
+            // Channel changes land between dwells, so the detectors in use
+            // are never touched by another thread.
+            applyCommands();
+
+            auto now = SweepScheduler::Clock::now();
+            if (m_current != ChannelTable::NONE)
+            {
+                m_scheduler.setAnomalous(m_current, m_table.isAnomalous(m_current), now);
+            }
+            size_t next = m_scheduler.next(now);
+            if (next == SweepScheduler::NONE)
             {
-                LOG(SOAPY_SDR_INFO, "Calibrating initial distribution for %f Hz", config->frequency);
-                while (anomDet->isReady() == false)
+                if (idle == false)
                 {
-                    void *buffs[] = {buff};
-                    int flags;
-                    long long time_ns;
-                    m_device->readStream(rx_stream, buffs, numElements, flags, time_ns, 1e5);
+                    idle = true;
+                    LOG(SOAPY_SDR_INFO, "%s has no channels; waiting for addFrequency()", m_driver.c_str());
+                }
+                std::this_thread::sleep_for(COMMAND_POLL_INTERVAL);
+                continue;
+            }
+            idle = false;
 
-                    psd->execute(buff, out);
+            if (next != m_current)
+            {
+                m_current = next;
+                frequency = m_table.getFrequency(m_current);
+                configure(frequency, BANDWIDTH_HZ);
+                m_metrics.add(PipelineMetrics::Counter::Retunes);
+                channel = &m_table.detectors(m_current);
+                psd = &channel->psd;
+                anomDet = &channel->anomDet;
+                binDet = &channel->binDet;
+                if (anomDet->isReady() == false && loadModel(*anomDet, frequency) == true)
+                {
+                    m_table.syncModel(m_current);
+                }
+
+                size_t newNumElements = psd->getFftSize();
+                if (newNumElements != numElements)
+                {
+                    // Hand the old frames back first so hopping between a
+                    // fixed set of FFT sizes recycles buffers instead of
+                    // allocating.
+                    psdFrame.reset();
+                    outFrame.reset();
+
+                    numElements = newNumElements;
+                    psdFrame = pool.acquire<float>(numElements);
+                    outFrame = pool.acquire<std::complex<float>>(DWELL_READS * numElements);
+                    psdReal = psdFrame.data();
+                    out = outFrame.data();
+
+                    // One read per dwell unless a chunk size is configured.
+                    size_t chunk = m_readChunk > 0 ? m_readChunk : std::min(m_device->getStreamMTU(rx_stream), DWELL_READS * numElements);
+                    reader.setGeometry(numElements, chunk, m_sampleRate);
+                }
+                else
+                {
+                    // Anything buffered was captured on the old frequency.
+                    reader.reset();
+                }
+
+                discardSettling(reader);
+            }
+
+            if (anomDet->isReady() == false)
+            {
+                // One spaced-out sample per visit, so calibrating a new
+                // channel does not hold up the sweep over the others. Only
+                // a channel revisited within the spacing waits, and only
+                // for the remainder.
+                if (anomDet->getSampleCount() == 0)
+                {
+                    LOG(SOAPY_SDR_INFO, "Calibrating initial distribution for %f Hz", frequency);
+                }
+                auto due = channel->lastCalibrationSample + std::chrono::milliseconds(TIME_BETWEEN_CALIBRATION_SAMPLE_COLLECT_MS);
+                std::this_thread::sleep_until(due);
+                if (reader.next(frame) == true)
+                {
+                    channel->lastCalibrationSample = std::chrono::steady_clock::now();
+                    psd->execute(frame.samples, m_sampleFormat, out);
+                    m_framesProcessed.fetch_add(1, std::memory_order_relaxed);
 
                     float avgPower = static_cast<float>(psd->computeAvgPower(out));
                     anomDet->pushSample(avgPower);
-                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
                 }
-                anomDet->processDistribution();
-                m_currentTimeS = std::chrono::system_clock::now();
-                m_lastSampleCollectedS = std::chrono::system_clock::now();
-                m_lastDistributionProcessedS = std::chrono::system_clock::now();
-                LOG(SOAPY_SDR_INFO, "Calibrating initial distribution completed for %f Hz", config->frequency);
+
+                // Calibration samples are spaced in time, so the rest of
+                // the chunk is stale.
+                reader.reset();
+                if (anomDet->isReady() == true)
+                {
+                    {
+                        PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Refit, false);
+                        anomDet->processDistribution();
+                    }
+                    m_table.syncModel(m_current);
+                    saveModel(*anomDet, frequency);
+                    publishDistribution(*anomDet);
+                    m_currentTimeS = std::chrono::system_clock::now();
+                    m_lastSampleCollectedS = std::chrono::system_clock::now();
+                    m_lastDistributionProcessedS = std::chrono::system_clock::now();
+                    LOG(SOAPY_SDR_INFO, "Calibrating initial distribution completed for %f Hz", frequency);
+                }
             }
             else
             {
-                for (size_t rep = 0; rep <= Dsp::AnomalyDetection::CONSECUTIVE_COUNT; rep++)
+                // The whole dwell is usually one chunk, transformed with a
+                // single batched FFT.
+                size_t done = 0;
+                while (done < DWELL_READS)
                 {
-                    void *buffs[] = {buff};
-                    int flags;
-                    long long time_ns;
-                    m_device->readStream(rx_stream, buffs, numElements, flags, time_ns, 1e5);
-
-                    psd->execute(buff, out);
-
-                    float avgPower = static_cast<float>(psd->computeAvgPower(out));
+                    size_t frames = reader.next(frame, DWELL_READS - done);
+                    if (frames == 0)
+                    {
+                        done++;
+                        continue;
+                    }
+                    done += frames;
+                    recordIq(frame.samples, frames * numElements, frame.timeNs, frequency);
 
-                    bool isAnom = anomDet->isAnomaly(avgPower);
+                    {
+                        PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Fft);
+                        psd->executeBatch(frame.samples, m_sampleFormat, frames, out);
+                    }
+                    m_framesProcessed.fetch_add(frames, std::memory_order_relaxed);
+                    m_table.addFrames(m_current, frames);
 
-                    if (isAnom == false)
+                    for (size_t f = 0; f < frames; f++)
                     {
-                        if (*anom == true)
+                        const std::complex<float> *spectrum = out + f * numElements;
+                        int64_t timeNs = frame.timeNs + static_cast<int64_t>(static_cast<double>(f * numElements) * 1e9 / m_sampleRate);
+
+                        float avgPower;
                         {
-                            *anom = false;
-                            LOG(SOAPY_SDR_INFO, "🔴 Anomaly Ended @ %f Hz", config->frequency);
+                            PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Power);
+                            avgPower = static_cast<float>(psd->computeAvgPower(spectrum));
+                            psd->computeRealPsd(spectrum, psdReal, m_sampleRate);
                         }
 
-                        if (isTimeToCollectSample())
+                        bool isAnom;
                         {
-                            anomDet->pushSample(avgPower);
+                            PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Detection);
+                            if (anomDet->updateModel() == true)
+                            {
+                                m_table.syncModel(m_current);
+                                saveModel(*anomDet, frequency);
+                                publishDistribution(*anomDet);
+                            }
+                            isAnom = anomDet->isAnomaly(avgPower);
+                            binDet->process(psdReal, numElements);
                         }
-                        if (isTimeToProcessSampleDistribution())
+
+                        if (isAnom == false)
                         {
-                            anomDet->processDistribution();
+                            if (m_table.isAnomalous(m_current) == true)
+                            {
+                                m_table.setAnomalous(m_current, false);
+                                LOG(SOAPY_SDR_INFO, "🔴 Anomaly Ended @ %f Hz", frequency);
+                            }
+
+                            if (isTimeToCollectSample())
+                            {
+                                PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Refit, false);
+                                anomDet->pushSample(avgPower);
+                                anomDet->refitLocationScale();
+                                m_table.syncModel(m_current);
+                            }
+                            if (isTimeToProcessSampleDistribution())
+                            {
+                                PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Refit, false);
+                                anomDet->requestRefit();
+                            }
                         }
-                    }
-                    else
-                    {
-                        if (*anom == false)
+                        else
                         {
-                            *anom = true;
-                            LOG(SOAPY_SDR_INFO, "🔵 Anomaly Detected @ %f Hz", config->frequency);
+                            if (m_table.isAnomalous(m_current) == false)
+                            {
+                                m_table.setAnomalous(m_current, true);
+                                LOG(SOAPY_SDR_INFO, "🔵 Anomaly Detected @ %f Hz", frequency);
+                                triggerRecording();
+                            }
                         }
-                    }
 
-                    float avgPowerList[] = {avgPower};
-                    psd->toFile("avg_power_output.txt", m_frequency, m_bandwidth, avgPowerList, 1);
-                    psd->computeRealPsd(out, psdReal, m_sampleRate);
-                    psd->toFile("psd_output.txt", m_frequency, m_bandwidth, psdReal, numElements);
+                        PipelineMetrics::ScopedTimer timer(m_metrics, PipelineMetrics::Stage::Output);
+                        publishAvgPower(avgPower, timeNs);
+                        publishPsd(psdReal, numElements, timeNs);
+                        logBinAnomalies(*binDet, frequency);
+                    }
                 }
             }
 
-            if (m_configList.size() == 1)
-            {
-                continue;
-            }
-
-            auto *tConfig = &m_configList.next()->value;
-
-            if (config == tConfig)
-            {
-                continue;
-            }
-
-            config = tConfig;
-            configure(config->frequency, BANDWIDTH_HZ);
-            psd = &config->psd;
-            anom = &config->anomaly;
-            anomDet = &config->anomDet;
-
-            size_t newNumElements = psd->getFftSize();
-            if (newNumElements != numElements)
+            if (SweepScheduler::Clock::now() - m_lastChannelPublish >= CHANNEL_PUBLISH_INTERVAL)
             {
-                delete[] out;
-                delete[] buff;
-                delete[] psdReal;
-
-                numElements = newNumElements;
-                psdReal = new float[numElements];
-                out = new std::complex<float>[numElements];
-                buff = new std::complex<float>[numElements];
+                publishChannels();
             }
         }
     }
     catch (...)
     {
         LOG(SOAPY_SDR_ERROR, "Stopping %s run thread due to ERROR", m_driver.c_str());
-        delete[] out;
-        delete[] buff;
-        delete[] psdReal;
         m_device->deactivateStream(rx_stream, 0, 0);
         m_device->closeStream(rx_stream);
         throw;
     }
 
-    delete[] out;
-    delete[] buff;
-    delete[] psdReal;
-
     m_device->deactivateStream(rx_stream, 0, 0);
     m_device->closeStream(rx_stream);
 
     LOG(SOAPY_SDR_INFO, "Deactivated and closed %s RX stream successfully", m_driver.c_str());
+    publishChannels();
+    logRevisitLatency();
+}
+
+void RtlSdrV4::applyCommands()
+{
+    size_t applied = m_commands.drain([this](Command &command)
+                                      {
+                                          size_t index = m_table.find(command.frequency);
+                                          if (command.type == Command::Type::Add)
+                                          {
+                                              if (index == ChannelTable::NONE)
+                                              {
+                                                  index = m_table.insert(command.frequency, BANDWIDTH_HZ);
+                                                  m_scheduler.add(index, command.frequency);
+                                                  LOG(SOAPY_SDR_INFO, "Added %f Hz to %s", command.frequency, m_driver.c_str());
+                                              }
+                                              return;
+                                          }
+
+                                          if (index != ChannelTable::NONE)
+                                          {
+                                              m_scheduler.remove(index);
+                                              m_table.remove(index);
+                                              if (index == m_current)
+                                              {
+                                                  m_current = ChannelTable::NONE;
+                                              }
+                                              LOG(SOAPY_SDR_INFO, "Removed %f Hz from %s", command.frequency, m_driver.c_str());
+                                          }
+                                      });
+    if (applied > 0)
+    {
+        publishChannels();
+    }
+}
+
+void RtlSdrV4::publishChannels()
+{
+    auto channels = std::make_shared<std::vector<Model::ChannelInfo>>();
+    channels->reserve(m_table.size());
+    for (size_t i : m_table.active())
+    {
+        auto latency = m_scheduler.getRevisitLatency(i);
+        Model::ChannelInfo info;
+        info.frequency = m_table.getFrequency(i);
+        info.bandwidth = m_table.getBandwidth(i);
+        info.calibrated = m_table.detectors(i).anomDet.isReady();
+        info.anomaly = m_table.isAnomalous(i);
+        info.x0 = m_table.getX0(i);
+        info.sigma = m_table.getSigma(i);
+        info.lambda = m_table.getLambda(i);
+        info.frames = m_table.getFrameCount(i);
+        info.anomalies = m_table.getAnomalyCount(i);
+        info.visits = m_scheduler.getVisitCount(i);
+        info.revisitP50Ms = static_cast<double>(latency.quantile(0.5)) / 1e6;
+        info.revisitP99Ms = static_cast<double>(latency.quantile(0.99)) / 1e6;
+        channels->push_back(info);
+    }
+    m_channelSnapshot.store(std::move(channels));
+    m_lastChannelPublish = SweepScheduler::Clock::now();
+}
+
+void RtlSdrV4::addFrequency(double frequency)
+{
+    m_commands.push(Command{Command::Type::Add, frequency});
+}
+
+void RtlSdrV4::removeFrequency(double frequency)
+{
+    m_commands.push(Command{Command::Type::Remove, frequency});
+}
+
+std::vector<Model::ChannelInfo> RtlSdrV4::listChannels() const
+{
+    auto channels = m_channelSnapshot.load();
+    return channels != nullptr ? *channels : std::vector<Model::ChannelInfo>();
+}
+
+void RtlSdrV4::discardSettling(BurstReader &reader)
+{
+    size_t dropped = reader.discard(m_settleSamples);
+    m_metrics.add(PipelineMetrics::Counter::SettleSamples, static_cast<uint64_t>(dropped));
+}
+
+void RtlSdrV4::logRevisitLatency() const
+{
+    for (size_t i : m_table.active())
+    {
+        auto latency = m_scheduler.getRevisitLatency(i);
+        LOG(SOAPY_SDR_INFO, "%s @ %f Hz: %llu visits, revisit p50 %.1f ms, p99 %.1f ms, max %.1f ms",
+            m_driver.c_str(),
+            m_scheduler.getFrequency(i),
+            static_cast<unsigned long long>(m_scheduler.getVisitCount(i)),
+            static_cast<double>(latency.quantile(0.5)) / 1e6,
+            static_cast<double>(latency.quantile(0.99)) / 1e6,
+            static_cast<double>(latency.max) / 1e6);
+    }
 }
 
 void RtlSdrV4::setFrequencies(const std::vector<double> &frequencies)
 {
     for (auto &f : frequencies)
     {
-        Model::SdrRoundRobinConfig *config = new Model::SdrRoundRobinConfig();
-        config->anomaly = false;
-        config->bandwidth = BANDWIDTH_HZ;
-        config->frequency = f;
-        m_configList.emplace(*config);
-        delete config;
+        addFrequency(f);
     }
 }
 
+void RtlSdrV4::setSettleSamples(size_t samples)
+{
+    m_settleSamples = samples;
+}
+
+const SweepScheduler &RtlSdrV4::getScheduler() const
+{
+    return m_scheduler;
+}
+
 void RtlSdrV4::configure(double frequency,
                          double bandwidth,
                          double gain,
                          double sampleRate)
 {
     SdrBase::configure(frequency, bandwidth, gain, sampleRate);
-    m_configList.current()->value.psd.setFftSize(bandwidth);
+    if (m_table.contains(m_current) == true)
+    {
+        // Once per FFT size; later hops find the dwell's plan cached.
+        Dsp::PowerSpectralDensity &psd = m_table.detectors(m_current).psd;
+        psd.setFftSize(bandwidth);
+        psd.prepareBatch(DWELL_READS);
+    }
 }
\ No newline at end of file
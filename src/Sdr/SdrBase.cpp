@@ -5,6 +5,9 @@
 #include <complex>
 #include <exception>
 
+#include <pthread.h>
+#include <sched.h>
+
 #include <SoapySDR/Types.hpp>
 #include <SoapySDR/Device.hpp>
 #include <SoapySDR/Formats.hpp>
@@ -13,12 +16,19 @@
 #include "Sdr/SdrBase.hpp"
 #include "Dsp/PowerSpectralDensity.hpp"
 #include "Dsp/AnomalyDetection.hpp"
+#include "Dsp/SpectralAnomalyDetection.hpp"
+#include "Io/SpectrumRing.hpp"
+#include "Io/ModelStore.hpp"
+#include "Io/IqRecorder.hpp"
 
 using namespace Sdr;
 
-SdrBase::SdrBase(const std::string &driver) : m_driver(driver)
+SdrBase::SdrBase(const std::string &driver, size_t index) : m_madeBySoapy(true),
+                                                             m_driver(driver),
+                                                             m_deviceId(driver + ":" + std::to_string(index))
 {
     bool found = false;
+    size_t matches = 0;
 
     SoapySDR::KwargsList kwargsList = SoapySDR::Device::enumerate();
     if (kwargsList.size() == 0)
@@ -34,8 +44,12 @@ SdrBase::SdrBase(const std::string &driver) : m_driver(driver)
             std::string key = it->first;
             std::string val = it->second;
 
-            if (key == "driver" && val == driver)
+            if (key == "driver" && val == driver && matches++ == index)
             {
+                if (kwargs.count("serial") > 0)
+                {
+                    m_deviceId = driver + ":" + kwargs.at("serial");
+                }
                 SoapySDR::Device *dev = SoapySDR::Device::make(kwargs);
                 m_device = std::unique_ptr<SoapySDR::Device>(dev);
 
@@ -52,18 +66,40 @@ SdrBase::SdrBase(const std::string &driver) : m_driver(driver)
 
     if (found == false)
     {
-        std::string e = "No " + driver + " driver found";
+        std::string e = "No " + driver + " driver found at index " + std::to_string(index);
         throw std::runtime_error(e);
     }
 
     m_running.store(false);
+    m_textOutput.store(false);
+    m_samplesRead.store(0);
+    m_framesProcessed.store(0);
+}
+
+SdrBase::SdrBase(const std::string &driver, std::unique_ptr<SoapySDR::Device> device) : m_madeBySoapy(false),
+                                                                                       m_device(std::move(device)),
+                                                                                       m_driver(driver),
+                                                                                       m_deviceId(driver)
+{
+    if (m_device == nullptr)
+    {
+        throw std::runtime_error("No device given for " + driver);
+    }
+
+    m_running.store(false);
+    m_textOutput.store(false);
+    m_samplesRead.store(0);
+    m_framesProcessed.store(0);
 }
 
 SdrBase::~SdrBase()
 {
     stop();
 
-    SoapySDR::Device::unmake(m_device.release());
+    if (m_madeBySoapy == true)
+    {
+        SoapySDR::Device::unmake(m_device.release());
+    }
 }
 
 void SdrBase::configure(double frequency,
@@ -109,11 +145,69 @@ void SdrBase::configure(double frequency,
 
 void SdrBase::run()
 {
+    if (m_thread.joinable())
+    {
+        return;
+    }
+
     m_running.store(true);
+    m_thread = std::thread(&SdrBase::threadMain, this);
+}
+
+void SdrBase::threadMain()
+{
+    applyThreadConfig(ThreadRole::Capture);
+
+    try
+    {
+        processThread();
+    }
+    catch (const std::exception &e)
+    {
+        LOG(SOAPY_SDR_ERROR, "%s process thread failed: %s", m_driver.c_str(), e.what());
+    }
+    catch (...)
+    {
+        LOG(SOAPY_SDR_ERROR, "%s process thread failed", m_driver.c_str());
+    }
+    m_running.store(false);
+}
+
+void SdrBase::setThreadConfig(const ThreadConfig &config)
+{
+    m_threadConfig = config;
+}
 
-    std::thread t(&SdrBase::processThread, this);
+void SdrBase::applyThreadConfig(ThreadRole role)
+{
+    int cpu = role == ThreadRole::Capture ? m_threadConfig.captureCpu : m_threadConfig.dspCpu;
+    const char *name = role == ThreadRole::Capture ? "capture" : "DSP";
 
-    t.detach();
+    if (cpu >= 0)
+    {
+#if defined(__linux__)
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0)
+        {
+            LOG(SOAPY_SDR_WARNING, "Failed to pin %s %s thread to CPU %d", m_driver.c_str(), name, cpu);
+        }
+#else
+        LOG(SOAPY_SDR_WARNING, "CPU pinning is not supported on this platform (%s %s thread)", m_driver.c_str(), name);
+#endif
+    }
+
+    if (m_threadConfig.realtimePriority > 0)
+    {
+        sched_param param{};
+        param.sched_priority = m_threadConfig.realtimePriority;
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0)
+        {
+            LOG(SOAPY_SDR_WARNING, "Failed to set SCHED_FIFO priority %d on %s %s thread",
+                m_threadConfig.realtimePriority, m_driver.c_str(), name);
+        }
+    }
 }
 
 bool SdrBase::isTimeToCollectSample()
@@ -129,6 +223,19 @@ bool SdrBase::isTimeToCollectSample()
     return false;
 }
 
+bool SdrBase::isTimeToCollectCalibrationSample()
+{
+    m_currentTimeS = std::chrono::system_clock::now();
+    auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(m_currentTimeS - m_lastCalibrationSampleS);
+    if (delta.count() >= TIME_BETWEEN_CALIBRATION_SAMPLE_COLLECT_MS)
+    {
+        m_lastCalibrationSampleS = m_currentTimeS;
+        return true;
+    }
+
+    return false;
+}
+
 bool SdrBase::isTimeToProcessSampleDistribution()
 {
     m_currentTimeS = std::chrono::system_clock::now();
@@ -143,11 +250,284 @@ bool SdrBase::isTimeToProcessSampleDistribution()
     return false;
 }
 
-void SdrBase::stop()
+void SdrBase::setTextOutput(bool enabled)
+{
+    m_textOutput.store(enabled);
+}
+
+void SdrBase::setOutputPrefix(const std::string &prefix)
+{
+    m_outputPrefix = prefix;
+}
+
+const std::string &SdrBase::getOutputPrefix() const
+{
+    return m_outputPrefix;
+}
+
+void SdrBase::setReadChunk(size_t samples)
+{
+    m_readChunk = samples;
+}
+
+void SdrBase::setNativeFormat(bool enabled)
+{
+    m_nativeFormat = enabled;
+}
+
+void SdrBase::setIqRecording(double preTriggerS, double postTriggerS)
+{
+    m_recordPreS = preTriggerS;
+    m_recordPostS = postTriggerS;
+}
+
+static bool toSampleFormat(const std::string &format, Dsp::SampleFormat::Type &type)
+{
+    static const std::map<std::string, Dsp::SampleFormat::Type> formats = {
+        {SOAPY_SDR_CF32, Dsp::SampleFormat::Type::CF32},
+        {SOAPY_SDR_CS16, Dsp::SampleFormat::Type::CS16},
+        {SOAPY_SDR_CS8, Dsp::SampleFormat::Type::CS8},
+        {SOAPY_SDR_CU8, Dsp::SampleFormat::Type::CU8},
+    };
+
+    auto it = formats.find(format);
+    if (it == formats.end())
+    {
+        return false;
+    }
+    type = it->second;
+    return true;
+}
+
+SoapySDR::Stream *SdrBase::setupRxStream()
+{
+    std::string format = SOAPY_SDR_CF32;
+    m_sampleFormat = Dsp::SampleFormat();
+    if (m_nativeFormat == true)
+    {
+        double fullScale = 0;
+        std::string native = m_device->getNativeStreamFormat(SOAPY_SDR_RX, 0, fullScale);
+        Dsp::SampleFormat::Type type;
+        if (toSampleFormat(native, type) == true && fullScale > 0)
+        {
+            format = native;
+            m_sampleFormat.type = type;
+            m_sampleFormat.scale = static_cast<float>(1.0 / fullScale);
+        }
+        else
+        {
+            LOG(SOAPY_SDR_WARNING, "%s native format %s is not supported, using CF32", m_driver.c_str(), native.c_str());
+        }
+    }
+
+    // The recorder follows the stream's format; recordIq() recreates it.
+    m_recorder.reset();
+
+    SoapySDR::Stream *stream = m_device->setupStream(SOAPY_SDR_RX, format);
+    if (stream == NULL)
+    {
+        throw std::runtime_error("Failed to set up stream");
+    }
+    LOG(SOAPY_SDR_INFO, "Streaming %s samples from %s", m_sampleFormat.name(), m_driver.c_str());
+    return stream;
+}
+
+static int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+void SdrBase::publishAvgPower(float avgPower, int64_t timeNs)
+{
+    float avgPowerList[] = {avgPower};
+    if (m_textOutput.load() == true)
+    {
+        Dsp::PowerSpectralDensity::toFile((m_outputPrefix + "avg_power_output.txt").c_str(), m_frequency, m_bandwidth, avgPowerList, 1);
+        return;
+    }
+
+    if (m_avgPowerRing == nullptr)
+    {
+        m_avgPowerRing = std::make_unique<Io::SpectrumRing>(m_outputPrefix + "avg_power_output.bin", 1, AVG_POWER_RING_SLOTS);
+    }
+    m_avgPowerRing->write(m_frequency, m_bandwidth, avgPowerList, 1, timeNs);
+}
+
+void SdrBase::publishPsd(float *psd, size_t size, int64_t timeNs)
+{
+    if (m_textOutput.load() == true)
+    {
+        Dsp::PowerSpectralDensity::toFile((m_outputPrefix + "psd_output.txt").c_str(), m_frequency, m_bandwidth, psd, size);
+        return;
+    }
+
+    if (m_psdRing == nullptr || m_psdRing->getBinCapacity() < size)
+    {
+        m_psdRing.reset();
+        m_psdRing = std::make_unique<Io::SpectrumRing>(m_outputPrefix + "psd_output.bin", static_cast<uint32_t>(size), PSD_RING_SLOTS);
+    }
+    m_psdRing->write(m_frequency, m_bandwidth, psd, size, timeNs);
+}
+
+void SdrBase::publishDistribution(const Dsp::AnomalyDetection &anomDet)
+{
+    if (m_textOutput.load() == true)
+    {
+        anomDet.toFile((m_outputPrefix + "cauchy_dist.txt").c_str());
+        return;
+    }
+
+    float params[] = {static_cast<float>(anomDet.getX0()),
+                      static_cast<float>(anomDet.getSigma()),
+                      static_cast<float>(anomDet.getLambda())};
+    if (m_distributionRing == nullptr)
+    {
+        m_distributionRing = std::make_unique<Io::SpectrumRing>(m_outputPrefix + "cauchy_dist.bin", 3, DISTRIBUTION_RING_SLOTS);
+    }
+    m_distributionRing->write(m_frequency, m_bandwidth, params, 3, nowNs());
+}
+
+void SdrBase::logBinAnomalies(const Dsp::SpectralAnomalyDetection &binDet, double frequency, double sampleRate)
+{
+    if (binDet.hasChanged() == false)
+    {
+        return;
+    }
+
+    auto ranges = binDet.getRanges();
+    if (ranges.empty())
+    {
+        LOG(SOAPY_SDR_INFO, "🔴 Narrowband anomalies ended on %s @ %f Hz", m_driver.c_str(), frequency);
+        return;
+    }
+
+    const size_t size = binDet.getSize();
+    const double binHz = (sampleRate > 0 ? sampleRate : m_sampleRate) / static_cast<double>(size);
+    for (auto &range : ranges)
+    {
+        double low = frequency + (static_cast<double>(range.first) - size / 2.0) * binHz;
+        double high = frequency + (static_cast<double>(range.second + 1) - size / 2.0) * binHz;
+        LOG(SOAPY_SDR_INFO, "🔵 Narrowband anomaly on %s: %f - %f Hz (%zu bins)",
+            m_driver.c_str(), low, high, range.second - range.first + 1);
+    }
+}
+
+void SdrBase::recordIq(const void *samples, size_t count, int64_t timeNs, double frequency)
+{
+    if (m_recordPreS <= 0 && m_recordPostS <= 0)
+    {
+        return;
+    }
+    // Created on the first block rather than with the stream: the RTL only
+    // sets its sample rate when it first tunes.
+    if (m_recorder == nullptr)
+    {
+        m_recorder = std::make_unique<Io::IqRecorder>(m_outputPrefix + "iq_", m_sampleFormat, m_sampleRate,
+                                                      m_recordPreS, m_recordPostS);
+    }
+    m_recorder->push(samples, count, timeNs, frequency);
+}
+
+void SdrBase::triggerRecording()
+{
+    if (m_recorder != nullptr && m_recorder->trigger() == true)
+    {
+        LOG(SOAPY_SDR_INFO, "Recording IQ from %s (%llu recorded, %llu failed, %llu samples dropped)",
+            m_driver.c_str(),
+            static_cast<unsigned long long>(m_recorder->getRecordingCount()),
+            static_cast<unsigned long long>(m_recorder->getFailedCount()),
+            static_cast<unsigned long long>(m_recorder->getDroppedSampleCount()));
+    }
+}
+
+void SdrBase::requestStop()
 {
     m_running.store(false);
 }
 
+void SdrBase::stop()
+{
+    requestStop();
+
+    if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id())
+    {
+        m_thread.join();
+    }
+}
+
+bool SdrBase::isRunning() const
+{
+    return m_running.load();
+}
+
+SdrBase::Stats SdrBase::getStats() const
+{
+    return Stats{m_samplesRead.load(std::memory_order_relaxed),
+                 m_framesProcessed.load(std::memory_order_relaxed)};
+}
+
+double SdrBase::getRequiredFrameRate() const
+{
+    return 0.0;
+}
+
+PipelineMetrics::Snapshot SdrBase::getMetrics() const
+{
+    return m_metrics.snapshot();
+}
+
+const std::string &SdrBase::getDriver() const
+{
+    return m_driver;
+}
+
+void SdrBase::setDeviceId(const std::string &id)
+{
+    m_deviceId = id;
+}
+
+const std::string &SdrBase::getDeviceId() const
+{
+    return m_deviceId;
+}
+
+void SdrBase::setModelStore(std::shared_ptr<Io::ModelStore> store)
+{
+    m_modelStore = std::move(store);
+}
+
+bool SdrBase::loadModel(Dsp::AnomalyDetection &anomDet, double frequency)
+{
+    if (m_modelStore == nullptr)
+    {
+        return false;
+    }
+
+    auto entry = m_modelStore->find(m_deviceId, frequency, m_gain);
+    if (entry.has_value() == false)
+    {
+        return false;
+    }
+
+    anomDet.warmStart(entry->params);
+    LOG(SOAPY_SDR_INFO, "Warm-started %s @ %f Hz from a stored model (x0 %g, sigma %g, lambda %g)",
+        m_deviceId.c_str(), frequency, entry->params.x0, entry->params.sigma, entry->params.lambda);
+    return true;
+}
+
+void SdrBase::saveModel(const Dsp::AnomalyDetection &anomDet, double frequency)
+{
+    if (m_modelStore == nullptr)
+    {
+        return;
+    }
+
+    Model::CauchyParams params{anomDet.getX0(), anomDet.getSigma(), anomDet.getLambda()};
+    m_modelStore->put(m_deviceId, frequency, m_gain, params, anomDet.getSampleCount());
+}
+
 double SdrBase::getGain() const
 {
     return m_gain;
@@ -0,0 +1,37 @@
+#include <chrono>
+#include <cstdlib>
+
+#include <SoapySDR/Constants.h>
+
+#include "Sdr/StreamClock.hpp"
+
+using namespace Sdr;
+
+int64_t StreamClock::toSystemNs(long long deviceNs, int flags, size_t samples, double sampleRate)
+{
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::system_clock::now().time_since_epoch())
+                      .count();
+    int64_t duration = sampleRate > 0 ? static_cast<int64_t>(static_cast<double>(samples) * 1e9 / sampleRate) : 0;
+    int64_t hostStart = now - duration;
+
+    if ((flags & SOAPY_SDR_HAS_TIME) == 0)
+    {
+        return hostStart;
+    }
+
+    int64_t estimate = static_cast<int64_t>(deviceNs) + m_offsetNs;
+    if (m_anchored == false || std::llabs(estimate - hostStart) > RESYNC_THRESHOLD_NS)
+    {
+        m_offsetNs = hostStart - static_cast<int64_t>(deviceNs);
+        m_anchored = true;
+        estimate = hostStart;
+    }
+    return estimate;
+}
+
+void StreamClock::reset()
+{
+    m_anchored = false;
+    m_offsetNs = 0;
+}
@@ -0,0 +1,189 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "Sdr/SweepScheduler.hpp"
+
+using namespace Sdr;
+
+void SweepScheduler::add(size_t index, double frequency)
+{
+    if (index >= m_channels.size())
+    {
+        m_channels.resize(index + 1);
+    }
+
+    // Start level with the others so a late channel neither starves them
+    // nor waits behind them.
+    Channel channel;
+    channel.frequency = frequency;
+    channel.pass = minPass();
+    channel.live = true;
+    channel.revisit = std::make_unique<Ds::LatencyHistogram>();
+    if (m_channels[index].live == false)
+    {
+        m_size++;
+    }
+    m_channels[index] = std::move(channel);
+}
+
+void SweepScheduler::remove(size_t index)
+{
+    if (index >= m_channels.size() || m_channels[index].live == false)
+    {
+        return;
+    }
+
+    m_channels[index].live = false;
+    m_channels[index].revisit.reset();
+    m_size--;
+    if (m_current == index)
+    {
+        m_current = NONE;
+    }
+}
+
+size_t SweepScheduler::size() const
+{
+    return m_size;
+}
+
+bool SweepScheduler::empty() const
+{
+    return m_size == 0;
+}
+
+size_t SweepScheduler::current() const
+{
+    return m_current;
+}
+
+double SweepScheduler::minPass() const
+{
+    double lowest = std::numeric_limits<double>::infinity();
+    for (auto &channel : m_channels)
+    {
+        if (channel.live == true)
+        {
+            lowest = std::min(lowest, channel.pass);
+        }
+    }
+    return std::isinf(lowest) ? 0.0 : lowest;
+}
+
+size_t SweepScheduler::next(Clock::time_point now)
+{
+    if (m_size == 0)
+    {
+        m_current = NONE;
+        return NONE;
+    }
+
+    double from = m_lastFrequency;
+    if (m_current != NONE)
+    {
+        Channel &previous = m_channels[m_current];
+        previous.pass += 1.0 / getWeight(m_current, now);
+        previous.lastLeft = now;
+        previous.visited = true;
+        from = previous.frequency;
+    }
+
+    const double horizon = minPass() + 1.0 / QUIET_WEIGHT;
+    size_t best = NONE;
+    for (size_t i = 0; i < m_channels.size(); i++)
+    {
+        const Channel &channel = m_channels[i];
+        if (channel.live == false || i == m_current || channel.pass >= horizon)
+        {
+            continue;
+        }
+
+        if (best == NONE)
+        {
+            best = i;
+            continue;
+        }
+
+        // Nearest first; on a tie keep sweeping the same way, then prefer
+        // the channel that is further behind.
+        double distance = std::fabs(channel.frequency - from);
+        double bestDistance = std::fabs(m_channels[best].frequency - from);
+        if (distance != bestDistance)
+        {
+            if (distance < bestDistance)
+            {
+                best = i;
+            }
+            continue;
+        }
+        bool ahead = (channel.frequency - from) * m_direction > 0.0;
+        bool bestAhead = (m_channels[best].frequency - from) * m_direction > 0.0;
+        if ((ahead == true && bestAhead == false) || (ahead == bestAhead && channel.pass < m_channels[best].pass))
+        {
+            best = i;
+        }
+    }
+
+    if (best == NONE)
+    {
+        // Only the current channel is due: keep dwelling without a retune.
+        return m_current;
+    }
+
+    Channel &chosen = m_channels[best];
+    if (chosen.visited == true)
+    {
+        auto unobserved = std::chrono::duration_cast<std::chrono::nanoseconds>(now - chosen.lastLeft);
+        chosen.revisit->record(static_cast<uint64_t>(std::max<int64_t>(0, unobserved.count())));
+    }
+    chosen.visits++;
+    if (chosen.frequency != from)
+    {
+        m_direction = chosen.frequency > from ? 1.0 : -1.0;
+    }
+    m_lastFrequency = chosen.frequency;
+    m_current = best;
+    return m_current;
+}
+
+void SweepScheduler::setAnomalous(size_t index, bool anomalous, Clock::time_point now)
+{
+    Channel &channel = m_channels.at(index);
+    channel.anomalous = anomalous;
+    if (anomalous == true)
+    {
+        channel.active = true;
+        channel.lastAnomaly = now;
+    }
+}
+
+double SweepScheduler::getFrequency(size_t index) const
+{
+    return m_channels.at(index).frequency;
+}
+
+double SweepScheduler::getWeight(size_t index, Clock::time_point now) const
+{
+    const Channel &channel = m_channels.at(index);
+    if (channel.anomalous == true)
+    {
+        return ANOMALOUS_WEIGHT;
+    }
+    if (channel.active == true && now - channel.lastAnomaly < ACTIVE_HOLD)
+    {
+        return ACTIVE_WEIGHT;
+    }
+    return QUIET_WEIGHT;
+}
+
+uint64_t SweepScheduler::getVisitCount(size_t index) const
+{
+    return m_channels.at(index).visits;
+}
+
+Ds::LatencyHistogram::Snapshot SweepScheduler::getRevisitLatency(size_t index) const
+{
+    const Channel &channel = m_channels.at(index);
+    return channel.revisit != nullptr ? channel.revisit->snapshot() : Ds::LatencyHistogram::Snapshot{};
+}